@@ -0,0 +1,175 @@
+// Measure parse_args and print_help cost for a generated set of options
+// Usage: ./bench [max_tokens]
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#include BENCH_DEFS
+#include "../includes/argus.h"
+
+// Run every measurement for at least this long
+#define BENCH_MIN_NS 100000000ull
+
+typedef struct {
+    int fd;
+} bench_counter_t;
+
+static bench_counter_t counter_open(void) {
+    bench_counter_t counter = {-1};
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type           = PERF_TYPE_HARDWARE;
+    attr.size           = sizeof(attr);
+    attr.config         = PERF_COUNT_HW_INSTRUCTIONS;
+    attr.disabled       = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    counter.fd          = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+    return counter;
+}
+
+static void counter_start(bench_counter_t counter) {
+#ifdef __linux__
+    if (counter.fd < 0) return;
+    ioctl(counter.fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(counter.fd, PERF_EVENT_IOC_ENABLE, 0);
+#else
+    (void)counter;
+#endif
+}
+
+// Number of instructions retired since counter_start, or -1 if the counter is unavailable
+static long long counter_stop(bench_counter_t counter) {
+    long long count = -1;
+#ifdef __linux__
+    if (counter.fd < 0) return -1;
+    ioctl(counter.fd, PERF_EVENT_IOC_DISABLE, 0);
+    if (read(counter.fd, &count, sizeof(count)) != sizeof(count)) count = -1;
+#else
+    (void)counter;
+#endif
+    return count;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Fill argv with the required arguments followed by random picks from bench_pool
+static void make_argv(const char** argv, int tokens) {
+    const int pool_size = (int)(sizeof(bench_pool) / sizeof(bench_pool[0]));
+    uint32_t  seed      = 12345;
+    int       argc      = 1;
+
+    argv[0]      = "bench";
+    argv[argc++] = "input.txt";
+    argv[argc++] = "8";
+    while (argc <= tokens) {
+        seed                      = seed * 1103515245u + 12345u;
+        const char* const* option = bench_pool[(seed >> 8) % pool_size];
+        if (option[1] != NULL && argc == tokens) continue;
+        argv[argc++] = option[0];
+        if (option[1] != NULL) argv[argc++] = option[1];
+    }
+}
+
+typedef struct {
+    double ns;
+    double instructions;
+} bench_result_t;
+
+static bench_result_t bench_parse(const char** argv, int tokens, bench_counter_t counter) {
+    bench_result_t result = {0, -1};
+    for (uint64_t iterations = 1;; iterations *= 2) {
+        counter_start(counter);
+        uint64_t start = now_ns();
+        for (uint64_t i = 0; i < iterations; i++) {
+            args_t args = make_default_args();
+            if (parse_args(tokens + 1, argv, &args)) exit(1);
+            __asm__ volatile("" : : "r"(&args) : "memory");
+        }
+        uint64_t  elapsed      = now_ns() - start;
+        long long instructions = counter_stop(counter);
+        if (elapsed >= BENCH_MIN_NS) {
+            result.ns = (double)elapsed / (double)(iterations * tokens);
+            if (instructions >= 0) result.instructions = (double)instructions / (double)(iterations * tokens);
+            return result;
+        }
+    }
+}
+
+static bench_result_t bench_help(bench_counter_t counter) {
+    bench_result_t result = {0, -1};
+    int            saved  = dup(STDOUT_FILENO);
+    int            null   = open("/dev/null", O_WRONLY);
+
+    fflush(stdout);
+    dup2(null, STDOUT_FILENO);
+    for (uint64_t iterations = 1;; iterations *= 2) {
+        counter_start(counter);
+        uint64_t start = now_ns();
+        for (uint64_t i = 0; i < iterations; i++) {
+            print_help("bench");
+        }
+        fflush(stdout);
+        uint64_t  elapsed      = now_ns() - start;
+        long long instructions = counter_stop(counter);
+        if (elapsed >= BENCH_MIN_NS) {
+            result.ns = (double)elapsed / (double)iterations;
+            if (instructions >= 0) result.instructions = (double)instructions / (double)iterations;
+            break;
+        }
+    }
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+    close(null);
+    return result;
+}
+
+static void print_result(const char* what, bench_result_t result) {
+    if (result.instructions >= 0) {
+        printf("%-16s %12.2f %14.2f\n", what, result.ns, result.instructions);
+    } else {
+        printf("%-16s %12.2f %14s\n", what, result.ns, "-");
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const int       max_tokens = argc > 1 ? atoi(argv[1]) : 1000000;
+    const char**    tokens     = malloc(sizeof(*tokens) * (size_t)(max_tokens + 1));
+    bench_counter_t counter    = counter_open();
+    char            label[32];
+
+    if (tokens == NULL || max_tokens < 10) {
+        fprintf(stderr, "Error: max_tokens has to be at least 10\n");
+        return 1;
+    }
+
+    printf("%d options\n", BENCH_OPTIONS);
+    printf("%-16s %12s %14s\n", "", "ns/token", "insns/token");
+    for (int count = 10; count <= max_tokens; count *= 10) {
+        make_argv(tokens, count);
+        snprintf(label, sizeof(label), "parse %d", count);
+        print_result(label, bench_parse(tokens, count, counter));
+    }
+    printf("%-16s %12s %14s\n", "", "ns/call", "insns/call");
+    print_result("print_help", bench_help(counter));
+
+    free(tokens);
+    return 0;
+}
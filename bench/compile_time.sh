@@ -0,0 +1,55 @@
+#!/bin/sh
+# Time preprocessing and compiling a translation unit that includes a generated argument set
+# Usage: ./compile_time.sh [options] [runs]
+# Set CC and CFLAGS to change the compiler, MODES to change the tested configurations.
+set -eu
+
+cd "$(dirname "$0")"
+mkdir -p build
+
+CC=${CC:-cc}
+CFLAGS=${CFLAGS:--O2}
+MODES=${MODES:-"default implementation declarations"}
+size=${1:-1000}
+runs=${2:-3}
+
+./gen_defs.sh "$size" > build/defs_$size.h
+cat > build/compile_$size.c << EOF
+#include <stddef.h>
+
+#include "defs_$size.h"
+#include "../../includes/argus.h"
+
+int compile_time_unit(void) { return (int)sizeof(args_t); }
+EOF
+
+# Best of $runs wall-clock milliseconds for the given command
+best_ms() {
+    best=""
+    run=0
+    while [ $run -lt "$runs" ]; do
+        start=$(date +%s%N)
+        "$@" > /dev/null
+        end=$(date +%s%N)
+        ms=$(((end - start) / 1000000))
+        if [ -z "$best" ] || [ "$ms" -lt "$best" ]; then best=$ms; fi
+        run=$((run + 1))
+    done
+    echo "$best"
+}
+
+printf '%-14s %12s %12s %14s\n' "mode" "preprocess" "compile" "expanded"
+for mode in $MODES; do
+    case $mode in
+    default) flags="" ;;
+    implementation) flags="-DARGUS_IMPLEMENTATION" ;;
+    declarations) flags="-DARGUS_DECLARATIONS_ONLY" ;;
+    *) echo "Unknown mode $mode" >&2 && exit 1 ;;
+    esac
+    # shellcheck disable=SC2086
+    preprocess=$(best_ms $CC $CFLAGS $flags -E build/compile_$size.c -o build/compile_${size}_$mode.i)
+    # shellcheck disable=SC2086
+    compile=$(best_ms $CC $CFLAGS $flags -c build/compile_$size.c -o build/compile_${size}_$mode.o)
+    bytes=$(wc -c < build/compile_${size}_$mode.i)
+    printf '%-14s %10sms %10sms %12sKB\n' "$mode" "$preprocess" "$compile" $((bytes / 1024))
+done
@@ -0,0 +1,74 @@
+#!/bin/sh
+# Generate an argument definition header with the given number of options
+# Usage: ./gen_defs.sh <options> > defs.h
+set -eu
+
+count=${1:?usage: gen_defs.sh <options>}
+letters="abcdefgijklmnopqrstuvwxyzABCDEFGIJKLMNOPQRSTUVWXYZ"
+optionals=$((count - count / 3))
+booleans=$((count - optionals))
+
+# Optional and boolean arguments each get half of the letters as short flags, the rest are long only
+short_for() {
+    if [ "$2" -lt $((${#letters} / 2)) ]; then
+        printf '%s' "$letters" | cut -c $(($1 * ${#letters} / 2 + $2 + 1))
+    else
+        printf 'NONE'
+    fi
+}
+
+echo "// Generated by gen_defs.sh $count, do not edit"
+echo
+echo "#define REQUIRED_ARGS \\"
+echo "    REQUIRED_STRING_ARG(input, \"input\", \"Input file\") \\"
+echo "    REQUIRED_INT_ARG(jobs, \"jobs\", \"Number of jobs\")"
+echo
+
+echo "#define OPTIONAL_ARGS \\"
+i=0
+while [ $i -lt $optionals ]; do
+    s=$(short_for 0 $i)
+    [ $i -eq $((optionals - 1)) ] && end="" || end=" \\"
+    case $((i % 3)) in
+    0) echo "    OPTIONAL_INT_ARG(opt$i, $s, opt$i, \"n\", 0, \"Integer option $i\")$end" ;;
+    1) echo "    OPTIONAL_STRING_ARG(opt$i, $s, opt$i, \"str\", \"\", \"String option $i\")$end" ;;
+    2) echo "    OPTIONAL_DOUBLE_ARG(opt$i, $s, opt$i, \"x\", 0.0, \"Double option $i\", 2)$end" ;;
+    esac
+    i=$((i + 1))
+done
+echo
+
+echo "#define BOOLEAN_ARGS \\"
+j=0
+while [ $j -lt $booleans ]; do
+    s=$(short_for 1 $j)
+    [ $j -eq $((booleans - 1)) ] && end="" || end=" \\"
+    echo "    BOOLEAN_ARG(flag$j, $s, flag$j, \"Boolean option $j\")$end"
+    j=$((j + 1))
+done
+echo
+
+# Tokens the driver draws from: flag, value (NULL if the token stands alone)
+echo "static const char* const bench_pool[][2] = {"
+i=0
+while [ $i -lt $optionals ]; do
+    s=$(short_for 0 $i)
+    case $((i % 3)) in
+    0) value="42" ;;
+    1) value="value" ;;
+    2) value="1.5" ;;
+    esac
+    echo "    {\"--opt$i\", \"$value\"},"
+    [ "$s" != NONE ] && echo "    {\"-$s$value\", NULL},"
+    i=$((i + 1))
+done
+j=0
+while [ $j -lt $booleans ]; do
+    s=$(short_for 1 $j)
+    echo "    {\"--flag$j\", NULL},"
+    [ "$s" != NONE ] && echo "    {\"-$s\", NULL},"
+    j=$((j + 1))
+done
+echo "};"
+echo
+echo "#define BENCH_OPTIONS $count"
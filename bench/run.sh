@@ -0,0 +1,29 @@
+#!/bin/sh
+# Build and run the benchmark for every option count and dispatch mode
+# Usage: ./run.sh [max_tokens]
+# Set CC and CFLAGS to change the compiler, MODES to change the tested configurations.
+set -eu
+
+cd "$(dirname "$0")"
+mkdir -p build
+
+CC=${CC:-cc}
+CFLAGS=${CFLAGS:--O2}
+MODES=${MODES:-"default hashed"}
+
+for size in 5 50 500; do
+    ./gen_defs.sh $size > build/defs_$size.h
+    for mode in $MODES; do
+        case $mode in
+        default) flags="" ;;
+        hashed) flags="-DARGUS_HASHED_LONGOPTS -DARGUS_INDEXED_SHORTOPTS" ;;
+        abbreviated) flags="-DARGUS_ABBREVIATED_LONGOPTS -DARGUS_INDEXED_SHORTOPTS" ;;
+        *) echo "Unknown mode $mode" >&2 && exit 1 ;;
+        esac
+        # shellcheck disable=SC2086
+        $CC $CFLAGS $flags "-DBENCH_DEFS=\"build/defs_$size.h\"" bench.c -o build/bench_${size}_$mode
+        echo "== $mode"
+        ./build/bench_${size}_$mode "$@"
+        echo
+    done
+done
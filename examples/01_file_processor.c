@@ -6,7 +6,7 @@
     REQUIRED_STRING_ARG(input_file, "input", "Input file path") \
     REQUIRED_STRING_ARG(output_file, "output", "Output file path")
 
-#define OPTIONAL_ARGS OPTIONAL_UINT_ARG(threads, t, threads, "threads", 1, "Number of threads to use")
+#define OPTIONAL_ARGS OPTIONAL_THREADS_ARG(threads, t, threads, "threads", 0, "Number of threads to use")
 
 #define BOOLEAN_ARGS BOOLEAN_ARG(help, h, help, "Show help")
 
@@ -25,7 +25,7 @@ int main(const int argc, const char* argv[]) {
 
     // 5. Use arguments
     printf("Processing %s -> %s\n", args.input_file, args.output_file);
-    printf("Threads: %u\n", args.threads);
+    printf("Threads: %u\n", argus_resolve_threads(args.threads));
 
     return 0;
 }
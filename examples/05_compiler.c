@@ -0,0 +1,33 @@
+// Usage: ./compiler [<sources>...] [-o<output>] [-v] [-I<dir>]... [-D<macro>]...
+#include <stdio.h>
+
+#define OPTIONAL_ARGS \
+    OPTIONAL_STRING_ARG(output, o, output, "output", "a.out", "Output file")
+
+#define BOOLEAN_ARGS                                   \
+    BOOLEAN_ARG(verbose, v, verbose, "Verbose output") \
+    BOOLEAN_ARG(help, NONE, help, "Print help")
+
+#define REPEATED_ARGS                                                           \
+    REPEATED_STRING_ARG(include, I, include, "dir", "Add an include directory") \
+    REPEATED_STRING_ARG(define, D, define, "macro", "Define a macro")           \
+    REPEATED_STRING_ARG(sources, NONE, NONE, "sources", "Source files")
+
+#include "../includes/argus.h"
+
+int main(int argc, const char* argv[]) {
+    args_t args = make_default_args();
+    char   arena[1024];
+
+    if (parse_args_arena(argc, argv, &args, arena, sizeof(arena)) || args.help || args.sources_count == 0) {
+        print_help(argv[0]);
+        return 1;
+    }
+
+    for (size_t i = 0; i < args.include_count; i++) printf("Include: %s\n", args.include[i]);
+    for (size_t i = 0; i < args.define_count; i++) printf("Define: %s\n", args.define[i]);
+    for (size_t i = 0; i < args.sources_count; i++) printf("Compiling %s\n", args.sources[i]);
+    printf("Linking %s\n", args.output);
+
+    return 0;
+}
@@ -0,0 +1,56 @@
+// Usage: ./store ingest <file> [-t<threads>] [-h]
+//        ./store compact [-l<level>] [-n] [-h]
+#include <stdio.h>
+
+// 1. Declare the arguments of every command, prefixed with the name of the command
+#define ARGUS_PREFIX ingest_
+#define REQUIRED_ARGS REQUIRED_STRING_ARG(file, "file", "File to load")
+#define OPTIONAL_ARGS OPTIONAL_UINT_ARG(threads, t, threads, "threads", 1, "Number of threads to use")
+#define BOOLEAN_ARGS BOOLEAN_ARG(help, h, help, "Show help")
+#include "../includes/argus.h"
+
+#define ARGUS_PREFIX compact_
+#define OPTIONAL_ARGS OPTIONAL_INT_ARG(level, l, level, "level", 0, "Level to compact")
+#define BOOLEAN_ARGS                                           \
+    BOOLEAN_ARG(dry_run, n, dry-run, "Only report the changes") \
+    BOOLEAN_ARG(help, h, help, "Show help")
+#include "../includes/argus.h"
+
+// 2. List the commands
+#define COMMANDS                                     \
+    COMMAND(ingest, "Load records into the store")   \
+    COMMAND(compact, "Merge segments of the store")
+#include "../includes/argus.h"
+
+int main(const int argc, const char* argv[]) {
+    commands_t commands;
+
+    // 3. Only the options of the chosen command are parsed
+    if (parse_command(argc, argv, &commands)) {
+        print_commands_help(argv[0]);
+        return 1;
+    }
+
+    switch (commands.command) {
+        case ARGUS_COMMAND_ingest:
+            if (commands.as.ingest.help) {
+                ingest_print_help("store ingest");
+                return 0;
+            }
+            printf("Loading %s with %u threads\n", commands.as.ingest.file, commands.as.ingest.threads);
+            break;
+        case ARGUS_COMMAND_compact:
+            if (commands.as.compact.help) {
+                compact_print_help("store compact");
+                return 0;
+            }
+            printf("%s level %d\n", commands.as.compact.dry_run ? "Would compact" : "Compacting",
+                   commands.as.compact.level);
+            break;
+        default:
+            break;
+    }
+
+    free_command(&commands);
+    return 0;
+}
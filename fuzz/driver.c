@@ -0,0 +1,42 @@
+// Runs the fuzz target on files, for AFL and for builds without libFuzzer
+// Usage: ./driver [file...] (reads stdin without files)
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+static int run(FILE* file) {
+    size_t   size = 0, capacity = 4096;
+    uint8_t* data = (uint8_t*)malloc(capacity);
+    if (data == NULL) return 1;
+    for (size_t n; (n = fread(data + size, 1, capacity - size, file)) > 0;) {
+        size += n;
+        if (size == capacity) {
+            uint8_t* grown = (uint8_t*)realloc(data, capacity *= 2);
+            if (grown == NULL) {
+                free(data);
+                return 1;
+            }
+            data = grown;
+        }
+    }
+    LLVMFuzzerTestOneInput(data, size);
+    free(data);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) return run(stdin);
+    for (int i = 1; i < argc; i++) {
+        FILE* file = fopen(argv[i], "rb");
+        if (file == NULL) {
+            perror(argv[i]);
+            return 1;
+        }
+        int error = run(file);
+        fclose(file);
+        if (error) return error;
+    }
+    return 0;
+}
@@ -0,0 +1,111 @@
+// Fuzz target for parse_args, parse_args_line, parse_config_buffer and argus_deserialize
+// The input is split on NUL bytes into argv. Build with -fsanitize=fuzzer, or link driver.c for AFL and plain runs.
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARGUS_CONFIG_FILES
+
+// Longest prefix of the input that is parsed as a single command line. Tokens are separated by blanks, so it splits
+// into at most half as many tokens as it has bytes, and the limit keeps every line under ARGUS_LINE_MAX_TOKENS.
+#define FUZZ_MAX_LINE (1 << 15)
+#define ARGUS_LINE_MAX_TOKENS (FUZZ_MAX_LINE / 2 + 1)
+
+// A bit of everything the examples use, with short flags that take values next to ones that don't
+#define REQUIRED_ARGS REQUIRED_STRING_ARG(input, "input", "Input file")
+
+#define OPTIONAL_ARGS                                                                  \
+    OPTIONAL_STRING_ARG(output, o, output, "file", "out", "Output file")               \
+    OPTIONAL_CHAR_ARG(mode, m, mode, "mode", 'a', "Mode")                              \
+    OPTIONAL_INT_ARG(level, l, level, "level", 0, "Level")                             \
+    OPTIONAL_UINT_ARG(threads, t, threads, "threads", 1, "Threads")                    \
+    OPTIONAL_ULONG_LONG_ARG(seed, s, seed, "seed", 0, "Seed")                          \
+    OPTIONAL_FLOAT_ARG(ratio, r, ratio, "ratio", 0.5f, "Ratio", 2)                     \
+    OPTIONAL_DOUBLE_ARG(scale, x, scale, "scale", 1.0, "Scale", 2)                     \
+    OPTIONAL_LONG_DOUBLE_ARG(epsilon, e, epsilon, "eps", 1e-9L, "Epsilon", 2)          \
+    OPTIONAL_INT_LIST_ARG(cpus, c, cpus, "list", "CPUs")                               \
+    OPTIONAL_DOUBLE_LIST_ARG(weights, w, weights, "list", "Weights")
+
+#define BOOLEAN_ARGS                                   \
+    BOOLEAN_ARG(verbose, v, verbose, "Verbose output") \
+    BOOLEAN_ARG(quiet, q, NONE, "Quiet")               \
+    BOOLEAN_ARG(force, NONE, force, "Force")
+
+#define REPEATED_ARGS                                                      \
+    REPEATED_STRING_ARG(include, I, include, "dir", "Include directory")   \
+    REPEATED_INT_ARG(define, D, define, "n", "Define")                     \
+    REPEATED_STRING_ARG(sources, NONE, NONE, "sources", "Source files")
+
+#include "../includes/argus.h"
+
+// Largest input that is split into argv, so a single run stays fast
+#define FUZZ_MAX_INPUT (1 << 20)
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    if (size > FUZZ_MAX_INPUT) return 0;
+
+    // Every byte may start a token, plus argv[0] and the terminating NULL
+    char*        text = (char*)malloc(size + 1);
+    const char** argv = (const char**)malloc((size + 3) * sizeof(const char*));
+    if (text == NULL || argv == NULL) {
+        free(text);
+        free(argv);
+        return 0;
+    }
+
+    memcpy(text, data, size);
+    text[size] = '\0';
+    int argc      = 0;
+    argv[argc++]  = "fuzz";
+    argv[argc++]  = text;
+    for (size_t i = 0; i < size; i++) {
+        if (text[i] == '\0') argv[argc++] = text + i + 1;
+    }
+    argv[argc] = NULL;
+
+    args_t        args = make_default_args();
+    argus_error_t err;
+    if (parse_args_ex(argc, argv, &args, &err) == 0) {
+#ifdef ARGUS_LAZY
+        // Lazy values are only parsed when asked for
+#define OPTIONAL_ARG(type, name, ...)                  \
+    {                                                  \
+        type value;                                    \
+        args_get_##name##_ex(&args, &value, &err);     \
+    }
+        OPTIONAL_ARGS
+#undef OPTIONAL_ARG
+#endif
+    }
+    free_args(&args);
+
+    char arena[256];
+    args = make_default_args();
+    parse_args_arena_ex(argc, argv, &args, arena, sizeof(arena), &err);
+
+    // The same bytes as a single command line and as a config file, both are split in place
+    memcpy(text, data, size);
+    text[size] = '\0';
+    size_t line = strlen(text);
+    if (line > FUZZ_MAX_LINE) line = FUZZ_MAX_LINE;
+    args = make_default_args();
+    parse_args_line_ex(text, line, &args, &err);
+    free_args(&args);
+
+    memcpy(text, data, size);
+    text[size] = '\0';
+    args       = make_default_args();
+    parse_config_buffer_ex(text, size, &args, &err);
+
+    // The raw bytes as a snapshot, which is mostly rejected by its header
+    args = make_default_args();
+    argus_deserialize(data, size, &args, &err);
+    free_args(&args);
+
+    free(argv);
+    free(text);
+    return 0;
+}
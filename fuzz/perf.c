@@ -0,0 +1,173 @@
+// Checks that parsing time grows linearly with the number of argv bytes on pathological inputs
+// Every case is timed at a small and a large size, and fails if time grows much faster than the input.
+// Usage: ./perf
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define ARGUS_CONFIG_FILES
+// The line case splits the large input into a few thousand tokens
+#define ARGUS_LINE_MAX_TOKENS (1 << 14)
+
+#define OPTIONAL_ARGS                                                   \
+    OPTIONAL_CHAR_ARG(mode, m, mode, "mode", 'a', "Mode")               \
+    OPTIONAL_INT_ARG(level, l, level, "level", 0, "Level")              \
+    OPTIONAL_DOUBLE_ARG(scale, x, scale, "scale", 1.0, "Scale", 2)      \
+    OPTIONAL_INT_LIST_ARG(cpus, c, cpus, "list", "CPUs")                \
+    OPTIONAL_STRING_ARG(output, o, output, "file", "out", "Output file")
+
+#define BOOLEAN_ARGS                                   \
+    BOOLEAN_ARG(verbose, v, verbose, "Verbose output") \
+    BOOLEAN_ARG(quiet, q, quiet, "Quiet")
+
+#define REPEATED_ARGS                                                    \
+    REPEATED_STRING_ARG(include, I, include, "dir", "Include directory") \
+    REPEATED_STRING_ARG(sources, NONE, NONE, "sources", "Source files")
+
+#include "../includes/argus.h"
+
+// Input sizes in bytes, the large one is PERF_GROWTH times the small one. Both stay small enough for the inputs to
+// fit in cache, past that the ratios measure the memory rather than the parser.
+#ifndef PERF_SMALL
+#define PERF_SMALL (1 << 12)
+#endif
+#define PERF_GROWTH 8
+#define PERF_RUNS 9
+
+// Linear growth takes PERF_GROWTH times as long, quadratic growth PERF_GROWTH^2 times
+#define PERF_MAX_RATIO (3 * PERF_GROWTH)
+
+typedef enum { PERF_ARGV, PERF_LINE, PERF_CONFIG } perf_kind_t;
+
+typedef struct {
+    const char* text;
+    size_t      len;  // The texts of argv inputs embed NUL separators
+} perf_text_t;
+
+#define PERF_TEXT(literal) {literal, sizeof(literal) - 1}
+
+typedef struct {
+    const char*        name;
+    perf_kind_t        kind;
+    perf_text_t        prefix;  // Written once at the start of the input
+    perf_text_t        repeat;  // Repeated until the input has the requested size
+    perf_text_t        suffix;  // Written once at the end of the input
+    argus_error_code_t code;    // How the parse ends at every size, a case that stops early doesn't measure anything
+} perf_case_t;
+
+// Lazy parsing leaves optional values alone until they are read, so their errors don't end the parse
+#ifdef ARGUS_LAZY
+#define PERF_VALUE_ERROR(code) ARGUS_OK
+#else
+#define PERF_VALUE_ERROR(code) ARGUS_ERROR_##code
+#endif
+
+// Tokens of argv inputs are separated by NUL bytes
+static const perf_case_t perf_cases[] = {
+    {"bundled boolean flags", PERF_ARGV, PERF_TEXT("-"), PERF_TEXT("vq"), PERF_TEXT(""), ARGUS_OK},
+    {"integer out of range", PERF_ARGV, PERF_TEXT("-l"), PERF_TEXT("9"), PERF_TEXT(""), PERF_VALUE_ERROR(OUT_OF_RANGE)},
+    {"many boolean tokens", PERF_ARGV, PERF_TEXT(""), PERF_TEXT("-v\0"), PERF_TEXT("-q"), ARGUS_OK},
+    {"many long options", PERF_ARGV, PERF_TEXT(""), PERF_TEXT("--verbose\0"), PERF_TEXT("--quiet"), ARGUS_OK},
+    {"many repeated values", PERF_ARGV, PERF_TEXT(""), PERF_TEXT("-Ia\0"), PERF_TEXT("-Ib"), ARGUS_OK},
+    {"many positional values", PERF_ARGV, PERF_TEXT(""), PERF_TEXT("src.c\0"), PERF_TEXT("last.c"), ARGUS_OK},
+    {"long unknown option", PERF_ARGV, PERF_TEXT("--"), PERF_TEXT("x"), PERF_TEXT(""), ARGUS_ERROR_INVALID_FLAG},
+    {"integer with leading zeros", PERF_ARGV, PERF_TEXT("-l"), PERF_TEXT("0"), PERF_TEXT("1"), ARGUS_OK},
+    {"decimal with many digits", PERF_ARGV, PERF_TEXT("--scale\0" "0."), PERF_TEXT("1"), PERF_TEXT(""), ARGUS_OK},
+    {"list past its capacity", PERF_ARGV, PERF_TEXT("--cpus\0"), PERF_TEXT("1,"), PERF_TEXT("1"),
+     PERF_VALUE_ERROR(OUT_OF_RANGE)},
+    {"line of tokens", PERF_LINE, PERF_TEXT(""), PERF_TEXT("-v \"a b\" 'c' \\d "), PERF_TEXT(""), ARGUS_OK},
+    {"config of many lines", PERF_CONFIG, PERF_TEXT(""), PERF_TEXT("level = 1\nverbose = yes\n# x\n"), PERF_TEXT(""),
+     ARGUS_OK},
+};
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static size_t perf_append(char* buf, size_t at, perf_text_t text) {
+    memcpy(buf + at, text.text, text.len);
+    return at + text.len;
+}
+
+// Build the input of a case with about size bytes, NUL terminated
+static size_t perf_build(const perf_case_t* c, char* buf, size_t size) {
+    size_t at = perf_append(buf, 0, c->prefix);
+    while (at + c->repeat.len + c->suffix.len <= size) at = perf_append(buf, at, c->repeat);
+    at      = perf_append(buf, at, c->suffix);
+    buf[at] = '\0';
+    return at;
+}
+
+// Time a single parse of the input, which is rebuilt first as lines and configs are split in place
+static uint64_t perf_run(const perf_case_t* c, char* buf, size_t size, const char** argv) {
+    const size_t len = perf_build(c, buf, size);
+    int argc     = 0;
+    argv[argc++] = "perf";
+    if (c->kind == PERF_ARGV) {
+        argv[argc++] = buf;
+        for (size_t i = 0; i < len; i++) {
+            if (buf[i] == '\0') argv[argc++] = buf + i + 1;
+        }
+    }
+    argv[argc] = NULL;
+
+    args_t        args = make_default_args();
+    argus_error_t err  = {.code = ARGUS_OK};
+    const uint64_t start = now_ns();
+    switch (c->kind) {
+        case PERF_ARGV:
+            parse_args_ex(argc, argv, &args, &err);
+            break;
+        case PERF_LINE:
+            parse_args_line_ex(buf, len, &args, &err);
+            break;
+        case PERF_CONFIG:
+            parse_config_buffer_ex(buf, len, &args, &err);
+            break;
+    }
+    const uint64_t elapsed = now_ns() - start;
+    free_args(&args);
+    if (err.code != c->code) {
+        fprintf(stderr, "%s: the parse of %zu bytes ended with error %d\n", c->name, len, (int)err.code);
+        exit(1);
+    }
+    return elapsed;
+}
+
+// Fastest of a few runs, to keep noise out of the ratio
+static uint64_t perf_best(const perf_case_t* c, char* buf, size_t size, const char** argv) {
+    uint64_t best = UINT64_MAX;
+    for (int run = 0; run < PERF_RUNS; run++) {
+        const uint64_t elapsed = perf_run(c, buf, size, argv);
+        if (elapsed < best) best = elapsed;
+    }
+    return best > 0 ? best : 1;
+}
+
+int main(void) {
+    const size_t large = (size_t)PERF_SMALL * PERF_GROWTH;
+    char*        buf   = (char*)malloc(large + 1);
+    const char** argv  = (const char**)malloc((large + 3) * sizeof(const char*));
+    if (buf == NULL || argv == NULL) return 1;
+
+    int failures = 0;
+    printf("%-28s %12s %12s %8s\n", "case", "small [us]", "large [us]", "ratio");
+    for (size_t i = 0; i < sizeof(perf_cases) / sizeof(perf_cases[0]); i++) {
+        const perf_case_t* c     = &perf_cases[i];
+        const uint64_t     small = perf_best(c, buf, PERF_SMALL, argv);
+        const uint64_t     big   = perf_best(c, buf, large, argv);
+        const double       ratio = (double)big / (double)small;
+        const bool         ok    = ratio <= PERF_MAX_RATIO;
+        printf("%-28s %12.1f %12.1f %8.1f%s\n", c->name, small / 1e3, big / 1e3, ratio, ok ? "" : "  SUPERLINEAR");
+        failures += !ok;
+    }
+
+    free(argv);
+    free(buf);
+    return failures > 0;
+}
@@ -0,0 +1,37 @@
+#!/bin/sh
+# Build the fuzz target and the scaling tests, run the target over the seeds and check the scaling
+# Usage: ./run.sh [seconds]
+# With clang the target is built with libFuzzer and fuzzes for the given time (60 by default). Otherwise it's built
+# with driver.c, which only replays the seeds. Set CC to change the compiler, MODES to change the tested
+# configurations.
+set -eu
+
+cd "$(dirname "$0")"
+mkdir -p build
+
+CC=${CC:-cc}
+MODES=${MODES:-"default hashed lazy table"}
+SANITIZE="-fsanitize=address,undefined -fno-sanitize-recover=undefined"
+
+for mode in $MODES; do
+    case $mode in
+    default) flags="" ;;
+    hashed) flags="-DARGUS_HASHED_LONGOPTS -DARGUS_INDEXED_SHORTOPTS" ;;
+    lazy) flags="-DARGUS_LAZY" ;;
+    table) flags="-DARGUS_TABLE_DRIVEN" ;;
+    *) echo "Unknown mode $mode" >&2 && exit 1 ;;
+    esac
+    echo "== $mode"
+    # shellcheck disable=SC2086
+    if $CC -fsanitize=fuzzer -x c /dev/null -o /dev/null 2>/dev/null; then
+        mkdir -p build/corpus_$mode
+        $CC -g -O1 $SANITIZE,fuzzer $flags fuzz_args.c -o build/fuzz_$mode
+        ./build/fuzz_$mode -max_total_time="${1:-60}" build/corpus_$mode seeds
+    else
+        $CC -g -O1 $SANITIZE $flags fuzz_args.c driver.c -o build/fuzz_$mode
+        ./build/fuzz_$mode seeds/*
+    fi
+    $CC -O2 $flags perf.c -o build/perf_$mode
+    ./build/perf_$mode
+    echo
+done
@@ -13,11 +13,60 @@
 */
 
 #include <errno.h>    // used for error handling in default parsers
+#include <float.h>    // used for FLT_EVAL_METHOD and float formats
+#include <limits.h>   // used for integer ranges
+#include <stdarg.h>   // used for formatting help text
 #include <stdbool.h>  // used for bool impl
-#include <stdio.h>    // used for IO
+#include <stddef.h>   // used for offsetof
+#include <stdint.h>   // used for option hashing and integer parsing
+#ifndef ARGUS_NO_STDIO
+#include <stdio.h>  // used for IO
+#endif
 #include <stdlib.h>   // used for parsing (atoi, atof)
 #include <string.h>   // used for strcmp
 
+#if (defined(ARGUS_RESPONSE_FILES) || defined(ARGUS_CONFIG_FILES)) && (defined(__unix__) || defined(__APPLE__))
+#include <fcntl.h>     // used for opening files
+#include <sys/mman.h>  // used for mapping files into memory
+#include <sys/stat.h>  // used for getting file sizes
+#include <unistd.h>    // used for closing files
+#if defined(_POSIX_MAPPED_FILES) && _POSIX_MAPPED_FILES > 0
+#define ARGUS_HAVE_MMAP
+#endif
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>  // used for counting processors and ARGUS_NO_STDIO output
+#endif
+#ifdef __linux__
+#include <fcntl.h>  // used for reading the CPU quota
+#endif
+
+#if defined(ARGUS_BATCH) && (defined(__unix__) || defined(__APPLE__))
+#include <pthread.h>  // used for parsing batches in parallel
+#define ARGUS_HAVE_PTHREADS
+#endif
+
+// parse_env() walks the environment directly instead of calling getenv() for every variable
+#ifdef _WIN32
+#define argus_environ _environ
+#else
+extern char** environ;
+#define argus_environ environ
+#endif
+
+// Every argument set defines its functions static inline, unless the header is split stb-style: exactly one file
+// defines ARGUS_IMPLEMENTATION before including the definitions, the others define ARGUS_DECLARATIONS_ONLY and only
+// see args_t, the accessors and the prototypes.
+#if defined(ARGUS_IMPLEMENTATION) && defined(ARGUS_DECLARATIONS_ONLY)
+#error "Define at most one of ARGUS_IMPLEMENTATION and ARGUS_DECLARATIONS_ONLY"
+#endif
+#if defined(ARGUS_IMPLEMENTATION) || defined(ARGUS_DECLARATIONS_ONLY)
+#define ARGUS_API
+#else
+#define ARGUS_API static inline
+#endif
+
 /**
  * @def REQUIRED_ARG(type, name, label, description, parser)
  * @brief Define required positional argument
@@ -39,7 +88,7 @@
 #define REQUIRED_LONG_LONG_ARG(name, label, description) REQUIRED_ARG(long long, name, label, description, parse_ll)
 #define REQUIRED_ULONG_LONG_ARG(name, label, description) \
     REQUIRED_ARG(unsigned long long, name, label, description, parse_ull)
-#define REQUIRED_SIZE_ARG(name, label, description) REQUIRED_ARG(size_t, name, label, description, parse_ull)
+#define REQUIRED_SIZE_ARG(name, label, description) REQUIRED_ARG(size_t, name, label, description, parse_size)
 #define REQUIRED_FLOAT_ARG(name, label, description) REQUIRED_ARG(float, name, label, description, parse_f)
 #define REQUIRED_DOUBLE_ARG(name, label, description) REQUIRED_ARG(double, name, label, description, parse_d)
 #define REQUIRED_LONG_DOUBLE_ARG(name, label, description) REQUIRED_ARG(long double, name, label, description, parse_ld)
@@ -79,7 +128,13 @@
 #define OPTIONAL_ULONG_LONG_ARG(name, shortopt, longopt, arg_label, default, description) \
     OPTIONAL_ARG(unsigned long long, name, shortopt, longopt, arg_label, default, description, "%llu", parse_ull)
 #define OPTIONAL_SIZE_ARG(name, shortopt, longopt, arg_label, default, description) \
-    OPTIONAL_ARG(size_t, name, shortopt, longopt, arg_label, default, description, "%zu", parse_ull)
+    OPTIONAL_ARG(size_t, name, shortopt, longopt, arg_label, default, description, "%zu", parse_size)
+#define OPTIONAL_BYTES_ARG(name, shortopt, longopt, arg_label, default, description) \
+    OPTIONAL_ARG(size_t, name, shortopt, longopt, arg_label, default, description, "%zu", parse_bytes)
+#define OPTIONAL_DURATION_ARG(name, shortopt, longopt, arg_label, default, description) \
+    OPTIONAL_ARG(unsigned long long, name, shortopt, longopt, arg_label, default, description, "%lluns", parse_duration)
+#define OPTIONAL_THREADS_ARG(name, shortopt, longopt, arg_label, default, description) \
+    OPTIONAL_ARG(unsigned int, name, shortopt, longopt, arg_label, default, description, "%u", parse_threads)
 #define OPTIONAL_FLOAT_ARG(name, shortopt, longopt, arg_label, default, description, precision) \
     OPTIONAL_ARG(float, name, shortopt, longopt, arg_label, default, description, "%." #precision "g", parse_f)
 #define OPTIONAL_DOUBLE_ARG(name, shortopt, longopt, arg_label, default, description, precision) \
@@ -87,6 +142,21 @@
 #define OPTIONAL_LONG_DOUBLE_ARG(name, shortopt, longopt, arg_label, default, description, precision) \
     OPTIONAL_ARG(long double, name, shortopt, longopt, arg_label, default, description, "%." #precision "g", parse_ld)
 
+/**
+ * @def OPTIONAL_LIST_ARG(type, name, shortopt, longopt, arg_label, description, parser)
+ * @brief Define an optional argument holding a comma separated list, which is empty by default
+ * @param type A list type with values and count members, e.g. argus_int_list_t
+ * @param parser A parser filling the whole list, e.g. parse_int_list
+ * Every other parameter is the same as for OPTIONAL_ARG. Lists are optional arguments in every other respect.
+ */
+#define OPTIONAL_INT_LIST_ARG(name, shortopt, longopt, arg_label, description) \
+    OPTIONAL_LIST_ARG(argus_int_list_t, name, shortopt, longopt, arg_label, description, parse_int_list)
+#define OPTIONAL_DOUBLE_LIST_ARG(name, shortopt, longopt, arg_label, description) \
+    OPTIONAL_LIST_ARG(argus_double_list_t, name, shortopt, longopt, arg_label, description, parse_double_list)
+#define ARGUS_LIST_AS_OPTIONAL(type, name, shortopt, longopt, arg_label, description, parser) \
+    OPTIONAL_ARG(type, name, shortopt, longopt, arg_label, {0}, description, "", parser)
+#define OPTIONAL_LIST_ARG ARGUS_LIST_AS_OPTIONAL
+
 /**
  * @def BOOLEAN_ARG(name, shortopt, longopt, description)
  * @brief Define an boolean argument (true/false)
@@ -96,406 +166,5684 @@
  * @param description A description of the argument
  */
 
-// PARSERS
-static inline int parse_str(const char* const text, char** out, const char** advance) {
-    *out = (char*)text;
-    if (advance != NULL) *advance = NULL;
-    return 0;
-}
-
-static inline int parse_char(const char* const text, char* out, const char** advance) {
-    *out = text[0];
-    if (advance != NULL) *advance = (char*)(text + 1);
-    return 0;
-}
-
-#define NUMBER_PARSER(type, shorthand, func)                                                       \
-    static inline int parse_##shorthand(const char* const text, type* out, const char** advance) { \
-        errno = 0;                                                                                 \
-        *out = (type)func(text, (char**)advance, 10);                                              \
-        if (errno != 0) {                                                                          \
-            fprintf(stderr, "Error: failed to parse '%s' as " #type, text);                        \
-            return 1;                                                                              \
-        }                                                                                          \
-        return 0;                                                                                  \
-    }
-
-#define FLOAT_PARSER(type, shorthand, func)                                                        \
-    static inline int parse_##shorthand(const char* const text, type* out, const char** advance) { \
-        errno = 0;                                                                                 \
-        *out = (type)func(text, (char**)advance);                                                  \
-        if (errno != 0) {                                                                          \
-            fprintf(stderr, "Error: failed to parse '%s' as " #type, text);                        \
-            return 1;                                                                              \
-        }                                                                                          \
-        return 0;                                                                                  \
-    }
+/* clang-format off */
+/**
+ * @def REPEATED_ARG(type, name, shortopt, longopt, arg_label, description, parser)
+ * @brief Define an argument that may be given any number of times
+ * @param type The type of a single value
+ * @param name The name of the array in the args_t struct. The number of values is stored in name_count.
+ * @param shortopt A single character which will be used for a short flag (NOT a char literal)
+ * @param longopt A string that will act as a long option (NOT a string literal)
+ * @param arg_label The label of the argument in the help string (a string literal)
+ * @param description A description of the argument
+ * @param parser A function for parsing a single value, the same as for OPTIONAL_ARG
+ * If both shortopt and longopt are NONE, the argument collects the positional arguments following the required ones.
+ */
+/* clang-format on */
+#define REPEATED_STRING_ARG(name, shortopt, longopt, arg_label, description) \
+    REPEATED_ARG(char*, name, shortopt, longopt, arg_label, description, parse_str)
+#define REPEATED_CHAR_ARG(name, shortopt, longopt, arg_label, description) \
+    REPEATED_ARG(char, name, shortopt, longopt, arg_label, description, parse_char)
+#define REPEATED_INT_ARG(name, shortopt, longopt, arg_label, description) \
+    REPEATED_ARG(int, name, shortopt, longopt, arg_label, description, parse_int)
+#define REPEATED_UINT_ARG(name, shortopt, longopt, arg_label, description) \
+    REPEATED_ARG(unsigned int, name, shortopt, longopt, arg_label, description, parse_uint)
+#define REPEATED_LONG_ARG(name, shortopt, longopt, arg_label, description) \
+    REPEATED_ARG(long, name, shortopt, longopt, arg_label, description, parse_l)
+#define REPEATED_ULONG_ARG(name, shortopt, longopt, arg_label, description) \
+    REPEATED_ARG(unsigned long, name, shortopt, longopt, arg_label, description, parse_ul)
+#define REPEATED_LONG_LONG_ARG(name, shortopt, longopt, arg_label, description) \
+    REPEATED_ARG(long long, name, shortopt, longopt, arg_label, description, parse_ll)
+#define REPEATED_ULONG_LONG_ARG(name, shortopt, longopt, arg_label, description) \
+    REPEATED_ARG(unsigned long long, name, shortopt, longopt, arg_label, description, parse_ull)
+#define REPEATED_SIZE_ARG(name, shortopt, longopt, arg_label, description) \
+    REPEATED_ARG(size_t, name, shortopt, longopt, arg_label, description, parse_size)
+#define REPEATED_FLOAT_ARG(name, shortopt, longopt, arg_label, description) \
+    REPEATED_ARG(float, name, shortopt, longopt, arg_label, description, parse_f)
+#define REPEATED_DOUBLE_ARG(name, shortopt, longopt, arg_label, description) \
+    REPEATED_ARG(double, name, shortopt, longopt, arg_label, description, parse_d)
+#define REPEATED_LONG_DOUBLE_ARG(name, shortopt, longopt, arg_label, description) \
+    REPEATED_ARG(long double, name, shortopt, longopt, arg_label, description, parse_ld)
 
-NUMBER_PARSER(unsigned long long, ull, strtoull)
-NUMBER_PARSER(unsigned long, ul, strtoul)
-NUMBER_PARSER(long long, ll, strtoll)
-NUMBER_PARSER(long, l, strtol)
-NUMBER_PARSER(unsigned int, uint, strtoul)
-NUMBER_PARSER(int, int, strtol)
-FLOAT_PARSER(float, f, strtof)
-FLOAT_PARSER(double, d, strtod)
-FLOAT_PARSER(long double, ld, strtold)
+/**
+ * @def ENV_ARG(name, env)
+ * @brief Let an optional or boolean argument be set through an environment variable, see parse_env()
+ * @param name The name of an optional or boolean argument
+ * @param env The name of the environment variable (NOT a string literal)
+ */
 
-// COUNT ARGUMENTS
-#ifdef REQUIRED_ARGS
-#define REQUIRED_ARG(...) +1
-static const int REQUIRED_ARG_COUNT = 0 REQUIRED_ARGS;
-#undef REQUIRED_ARG
-#else
-static const int REQUIRED_ARG_COUNT = 0;
-#endif
+// OUTPUT
+// Text goes to ARGUS_STDOUT or ARGUS_STDERR. Normally through stdio, in ARGUS_NO_STDIO mode through
+// ARGUS_WRITE(stream, data, length), a write(2) style sink, with the small formatter below in place of printf.
+enum { ARGUS_STDOUT = 1, ARGUS_STDERR = 2 };
 
-#ifdef OPTIONAL_ARGS
-#define OPTIONAL_ARG(...) +1
-static const int OPTIONAL_ARG_COUNT = 0 OPTIONAL_ARGS;
-#undef OPTIONAL_ARG
+#ifdef ARGUS_NO_STDIO
+#ifndef ARGUS_WRITE
+#if defined(__unix__) || defined(__APPLE__)
+// Output that can't be written is dropped, like a full stdio stream
+#define ARGUS_WRITE(stream, data, length) ((void)!write(stream, data, length))
 #else
-static const int OPTIONAL_ARG_COUNT = 0;
+#error "ARGUS_NO_STDIO needs ARGUS_WRITE(stream, data, length) on this platform"
 #endif
-
-#ifdef BOOLEAN_ARGS
-#define BOOLEAN_ARG(...) +1
-static const int BOOLEAN_ARG_COUNT = 0 BOOLEAN_ARGS;
-#undef BOOLEAN_ARG
-#else
-static const int BOOLEAN_ARG_COUNT = 0;
 #endif
 
-// ARG_T STRUCT
-#define REQUIRED_ARG(type, name, ...) type name;
-#define OPTIONAL_ARG(type, name, ...) type name;
-#define BOOLEAN_ARG(name, ...) bool name;
-// Stores argument values
+// Formatted text on its way to a buffer or a stream
 typedef struct {
-#ifdef REQUIRED_ARGS
-    REQUIRED_ARGS
-#endif
-#ifdef OPTIONAL_ARGS
-    OPTIONAL_ARGS
-#endif
-#ifdef BOOLEAN_ARGS
-    BOOLEAN_ARGS
-#endif
-} args_t;
-#undef REQUIRED_ARG
-#undef OPTIONAL_ARG
-#undef BOOLEAN_ARG
-
-// Build an args_t struct with assigned default values
-static inline args_t make_default_args() {
-    args_t args = {
-#define REQUIRED_ARG(type, name, ...) .name = (type)0,
-#define OPTIONAL_ARG(type, name, shortopt, longopt, arg_label, default, ...) .name = default,
-#define BOOLEAN_ARG(name, ...) .name = 0,
-
-#ifdef REQUIRED_ARGS
-        REQUIRED_ARGS
-#endif
-
-#ifdef OPTIONAL_ARGS
-            OPTIONAL_ARGS
-#endif
-
-#ifdef BOOLEAN_ARGS
-                BOOLEAN_ARGS
-#endif
-
-#undef REQUIRED_ARG
-#undef OPTIONAL_ARG
-#undef BOOLEAN_ARG
-    };
+    char*  data;    // Buffer the text is written to, NULL if it's only measured
+    size_t limit;   // Bytes data can hold before it's full
+    size_t length;  // Length of the text in data, may exceed limit when measuring
+    int    stream;  // Stream data is flushed to when full, -1 to keep the text in data
+} argus_sink_t;
 
-    return args;
+static inline void argus_sink_flush(argus_sink_t* sink) {
+    if (sink->stream >= 0 && sink->length > 0) ARGUS_WRITE(sink->stream, sink->data, sink->length);
+    if (sink->stream >= 0) sink->length = 0;
 }
 
-// Conditional flag generation
-#define PROBE_NONE ,
+static inline void argus_sink_put(argus_sink_t* sink, const char* text, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (sink->stream >= 0 && sink->length == sink->limit) argus_sink_flush(sink);
+        if (sink->length < sink->limit) sink->data[sink->length] = text[i];
+        sink->length++;
+    }
+}
 
-// This MUST be two steps to force the preprocessor to resolve the comma
-#define SELECT_3RD(a1, a2, a3, ...) a3
-#define EVAL_SELECT_3RD(args) SELECT_3RD args
+static inline void argus_sink_fill(argus_sink_t* sink, char c, int count) {
+    for (; count > 0; count--) argus_sink_put(sink, &c, 1);
+}
 
-// Logic Selector
-#define DO_NOTHING(...)
+// Conversion flags of a directive
+enum {
+    ARGUS_FORMAT_LEFT = 1,
+    ARGUS_FORMAT_ZERO = 2,
+    ARGUS_FORMAT_PLUS = 4,
+    ARGUS_FORMAT_SPACE = 8,
+    ARGUS_FORMAT_ALT = 16
+};
 
-// Insert macro if value is not NONE
-#define NOT_NONE(val, MACRO) EVAL_SELECT_3RD((PROBE_##val, DO_NOTHING, MACRO))
+// Write a converted directive padded to width. The sign or prefix goes in front of zero padding.
+static inline void argus_sink_field(argus_sink_t* sink, const char* prefix, const char* body, size_t length,
+                                    int width, int flags) {
+    const size_t prefix_length = strlen(prefix);
+    const int    padding       = width > (int)(prefix_length + length) ? width - (int)(prefix_length + length) : 0;
+    if (!(flags & (ARGUS_FORMAT_LEFT | ARGUS_FORMAT_ZERO))) argus_sink_fill(sink, ' ', padding);
+    argus_sink_put(sink, prefix, prefix_length);
+    if ((flags & (ARGUS_FORMAT_LEFT | ARGUS_FORMAT_ZERO)) == ARGUS_FORMAT_ZERO) argus_sink_fill(sink, '0', padding);
+    argus_sink_put(sink, body, length);
+    if (flags & ARGUS_FORMAT_LEFT) argus_sink_fill(sink, ' ', padding);
+}
 
-/**
- * @brief Parse arguments
- *
- * @param[in]  argc  Number of command-line arguments (standard main() argc).
- * @param[in]  argv  Array of argument strings (standard main() argv).
- * @param[in]  args  Pointer to an default args_t struct.
- *
- * @retval 1 Error
- * @retval 0 OK
- */
-static inline int parse_args(const int argc, const char* const argv[], args_t* args) {
-    if (!argc || !argv) {
-        fprintf(stderr, "Internal error: null args or argv.\n");
-        return 1;
+// Write the digits of value in base, at least precision of them
+static inline size_t argus_format_digits(char* out, uintmax_t value, unsigned base, bool upper, int precision) {
+    const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char        reversed[64];
+    size_t      count = 0;
+    while (value != 0) {
+        reversed[count++] = digits[value % base];
+        value /= base;
     }
+    while ((int)count < precision && count < sizeof(reversed)) reversed[count++] = '0';
+    for (size_t i = 0; i < count; i++) out[i] = reversed[count - 1 - i];
+    return count;
+}
 
-    // If not enough required arguments
-    if (argc < 1 + REQUIRED_ARG_COUNT) {
-        fprintf(stderr, "Not all required arguments included.\n");
-        return 1;
-    }
+// Largest number of significant digits produced, anything beyond is written as zeros
+#define ARGUS_FORMAT_DIGITS 40
 
-// Get required arguments
-#ifdef REQUIRED_ARGS
-#define REQUIRED_ARG(type, name, label, description, parser) \
-    do {                                                     \
-        int error = parser(argv[i++], &args->name, NULL);    \
-        if (error != 0) return 1;                            \
-    } while (0);
-    int i = 1;
-    REQUIRED_ARGS
-#undef REQUIRED_ARG
-#endif
+// Scale a finite, positive value into [1, 10) and return the power of ten it was scaled by. Long double arithmetic
+// is exact enough for the digits of a double, the last digits of a long double may differ from printf.
+static inline int argus_float_scale(long double* value) {
+    int exponent = 0;
+    for (; *value >= 1e256L; exponent += 256) *value /= 1e256L;
+    for (; *value >= 1e32L; exponent += 32) *value /= 1e32L;
+    for (; *value >= 10.0L; exponent++) *value /= 10.0L;
+    for (; *value < 1e-255L; exponent -= 256) *value *= 1e256L;
+    for (; *value < 1e-31L; exponent -= 32) *value *= 1e32L;
+    for (; *value < 1.0L; exponent--) *value *= 10.0L;
+    return exponent;
+}
 
-    // Get optional and boolean arguments
-    for (int i = 1 + REQUIRED_ARG_COUNT; i < argc; i++) {
-#define GENERATE_LONG_OPT(name, longopt, parser)                                                               \
-    if (!strcmp(argv[i], "--" #longopt)) {                                                                     \
-        if (i + 1 >= argc) {                                                                                   \
-            fprintf(stderr, "Error: option '%s' requires a value.\n", "--" #longopt);                          \
-            return 1;                                                                                          \
-        }                                                                                                      \
-        const char* next_char = NULL;                                                                          \
-        int error = parser(argv[++i], &args->name, &next_char);                                                \
-        if (error != 0) {                                                                                      \
-            return 1; /* The parser should notify the user of an error */                                      \
-        }                                                                                                      \
-        /* We don't allow parsing only part of an option */                                                    \
-        if (next_char != NULL && *next_char != '\0') {                                                         \
-            fprintf(stderr, "Error: couldn't parse argument '%s' for option '%s'.\n", argv[i], "--" #longopt); \
-            return 1;                                                                                          \
-        }                                                                                                      \
-        continue;                                                                                              \
+// Round a value scaled into [1, 10) to count digits. Returns 1 if rounding carried into another leading digit.
+static inline int argus_float_round(long double scaled, int count, char* digits) {
+    for (int i = 0; i < count; i++) {
+        int digit = (int)scaled;
+        if (digit > 9) digit = 9;
+        digits[i] = (char)('0' + digit);
+        scaled    = (scaled - digit) * 10.0L;
     }
-
-// This generates the long opt parsing for an optional argument if it's not NONE
-#define OPTIONAL_ARG(type, name, shortopt, longopt, arg_label, default, description, formatter, parser) \
-    NOT_NONE(longopt, GENERATE_LONG_OPT)(name, longopt, parser)
-
-#define GENERATE_LONG_BOOL(name, longopt)  \
-    if (!strcmp(argv[i], "--" #longopt)) { \
-        args->name = true;                 \
-        continue;                          \
+    // Exact ties round to even, like printf
+    if (scaled < 5.0L || (scaled == 5.0L && count > 0 && (digits[count - 1] - '0') % 2 == 0)) return 0;
+    int i = count - 1;
+    for (; i >= 0 && digits[i] == '9'; i--) digits[i] = '0';
+    if (i >= 0) {
+        digits[i]++;
+        return 0;
     }
+    digits[0] = '1';
+    return 1;
+}
 
-#define BOOLEAN_ARG(name, shortopt, longopt, description) NOT_NONE(longopt, GENERATE_LONG_BOOL)(name, longopt)
-
-#ifdef OPTIONAL_ARGS
-        OPTIONAL_ARGS
-#endif
+// Write the fixed notation of digits[0..count) whose first digit has the given power of ten, with precision
+// fraction digits
+static inline size_t argus_format_fixed(char* out, const char* digits, int count, int exponent, int precision,
+                                        bool point) {
+    size_t length = 0;
+    for (int power = exponent > 0 ? exponent : 0; power >= -precision; power--) {
+        if (power == -1 && (precision > 0 || point)) out[length++] = '.';
+        const int index = exponent - power;
+        out[length++]   = index >= 0 && index < count ? digits[index] : '0';
+    }
+    if (precision == 0 && point) out[length++] = '.';
+    return length;
+}
 
-#ifdef BOOLEAN_ARGS
-        BOOLEAN_ARGS
-#endif
+// Write the exponent notation of digits[0..count)
+static inline size_t argus_format_exponent(char* out, const char* digits, int count, int exponent, bool upper,
+                                           bool point) {
+    size_t length = 0;
+    out[length++] = digits[0];
+    if (count > 1 || point) out[length++] = '.';
+    for (int i = 1; i < count; i++) out[length++] = i < ARGUS_FORMAT_DIGITS ? digits[i] : '0';
+    out[length++] = upper ? 'E' : 'e';
+    out[length++] = exponent < 0 ? '-' : '+';
+    length += argus_format_digits(out + length, (uintmax_t)(exponent < 0 ? -exponent : exponent), 10, false, 2);
+    return length;
+}
 
-#undef OPTIONAL_ARG
-#undef BOOLEAN_ARG
+// Drop the trailing zeros of a fraction, and its point if nothing is left
+static inline size_t argus_strip_zeros(char* out, size_t length) {
+    size_t point = 0;
+    while (point < length && out[point] != '.') point++;
+    if (point == length) return length;
+    size_t mantissa_end = point;
+    while (mantissa_end < length && out[mantissa_end] != 'e' && out[mantissa_end] != 'E') mantissa_end++;
+    size_t end = mantissa_end;
+    while (end > point + 1 && out[end - 1] == '0') end--;
+    if (end == point + 1) end = point;
+    memmove(out + end, out + mantissa_end, length - mantissa_end);
+    return end + (length - mantissa_end);
+}
 
-        // Parse flags
-        if (argv[i][0] == '-') {
-            const char* curr_flag = argv[i] + 1;
-#define GENERATE_SHORT_OPT(name, shortopt, parser)                                    \
-    if (*curr_flag == #shortopt[0]) {                                                 \
-        if (curr_flag[1] == '\0') {                                                   \
-            fprintf(stderr, "Error: option '%s' requires a value.\n", "-" #shortopt); \
-            return 1;                                                                 \
-        }                                                                             \
-        int error = parser(curr_flag + 1, &args->name, &curr_flag);                   \
-        if (error != 0) {                                                             \
-            return 1; /* The parser should notify the user of an error */             \
-        }                                                                             \
-        /* We set the flag to NULL when we read all of the remaning string  */        \
-        /* We treat any left string as the next flag */                               \
-        continue;                                                                     \
+// Convert value for %e, %f or %g
+static inline void argus_format_float(argus_sink_t* sink, long double value, char conversion, int precision,
+                                      int width, int flags) {
+    const bool  upper    = conversion >= 'A' && conversion <= 'Z';
+    const bool  negative = value < 0 || (value == 0 && 1.0L / value < 0);
+    const char* sign     = negative ? "-" : (flags & ARGUS_FORMAT_PLUS) ? "+" : (flags & ARGUS_FORMAT_SPACE) ? " " : "";
+    const bool  point    = (flags & ARGUS_FORMAT_ALT) != 0;
+    if (negative) value = -value;
+    if (value != value || value - value != 0) {
+        const char* text = value != value ? (upper ? "NAN" : "nan") : (upper ? "INF" : "inf");
+        argus_sink_field(sink, sign, text, 3, width, flags & ~ARGUS_FORMAT_ZERO);
+        return;
     }
+    if (precision < 0) precision = 6;
 
-#define OPTIONAL_ARG(type, name, shortopt, longopt, arg_label, default, description, formatter, parser) \
-    NOT_NONE(shortopt, GENERATE_SHORT_OPT)(name, shortopt, parser)
+    // Fixed notation is limited to this many digits on either side of the point, enough for every double. Larger
+    // values switch to exponent notation.
+    enum { ARGUS_FIXED_LIMIT = 320 };
+    if (precision > ARGUS_FIXED_LIMIT) precision = ARGUS_FIXED_LIMIT;
+    char       digits[ARGUS_FORMAT_DIGITS];
+    char       out[2 * ARGUS_FIXED_LIMIT + ARGUS_FORMAT_DIGITS + 16];
+    size_t     length    = 0;
+    const char lowercase = (char)(upper ? conversion - 'A' + 'a' : conversion);
+    const int  scale     = value == 0 ? 0 : argus_float_scale(&value);
+    int        exponent  = scale;
+    memset(digits, '0', sizeof(digits));
 
-#define GENERATE_SHORT_BOOL(name, shortopt) \
-    if (*curr_flag == #shortopt[0]) {       \
-        args->name = true;                  \
-        curr_flag++;                        \
-        continue;                           \
+    if (lowercase == 'f' && scale < ARGUS_FIXED_LIMIT) {
+        // Significant digits down to the last fraction digit
+        const int count = scale + 1 + precision;
+        if (value != 0 && count > 0) {
+            exponent += argus_float_round(value, count < ARGUS_FORMAT_DIGITS ? count : ARGUS_FORMAT_DIGITS, digits);
+        } else if (value != 0 && count == 0 && value > 5.0L) {
+            // Only the rounding of the last fraction digit is left, an exact tie goes to the even 0
+            digits[0] = '1';
+            exponent  = -precision;
+        } else {
+            exponent = 0;
+        }
+        length = argus_format_fixed(out, digits, ARGUS_FORMAT_DIGITS, exponent, precision, point);
+    } else {
+        // %g keeps at least one significant digit, %e and %f in exponent notation one in front of the point
+        const int significant = lowercase == 'g' ? (precision == 0 ? 1 : precision) : precision + 1;
+        if (value != 0) {
+            exponent += argus_float_round(value, significant < ARGUS_FORMAT_DIGITS ? significant : ARGUS_FORMAT_DIGITS,
+                                          digits);
+        }
+        if (lowercase == 'g' && exponent >= -4 && exponent < significant) {
+            length = argus_format_fixed(out, digits, ARGUS_FORMAT_DIGITS, exponent, significant - 1 - exponent, point);
+        } else {
+            length = argus_format_exponent(out, digits, significant, exponent, upper, point);
+        }
+        if (lowercase == 'g' && !point) length = argus_strip_zeros(out, length);
     }
+    argus_sink_field(sink, sign, out, length, width, flags);
+}
 
-#define BOOLEAN_ARG(name, shortopt, longopt, description) NOT_NONE(shortopt, GENERATE_SHORT_BOOL)(name, shortopt)
-
-            while (curr_flag != NULL && *curr_flag != '\0') {
-#ifdef OPTIONAL_ARGS
-                OPTIONAL_ARGS
-#endif
-
-#ifdef BOOLEAN_ARGS
-                BOOLEAN_ARGS
-#endif
+/**
+ * @brief Format text like vprintf, into a sink
+ *
+ * Knows the flags, field widths, precisions and length modifiers of C99 for the conversions d, i, u, o, x, X, c,
+ * s, p, e, E, f, F, g, G and %. Floats are converted with at most ARGUS_FORMAT_DIGITS significant digits.
+ */
+static inline void argus_vformat(argus_sink_t* sink, const char* format, va_list ap) {
+    while (*format != '\0') {
+        const char* literal = format;
+        while (*format != '\0' && *format != '%') format++;
+        argus_sink_put(sink, literal, (size_t)(format - literal));
+        if (*format == '\0') break;
+        format++;
 
-                fprintf(stderr, "Error: Invalid flag '-%s'\n", curr_flag);
-                return 1;
+        int flags = 0;
+        for (;; format++) {
+            if (*format == '-') flags |= ARGUS_FORMAT_LEFT;
+            else if (*format == '0') flags |= ARGUS_FORMAT_ZERO;
+            else if (*format == '+') flags |= ARGUS_FORMAT_PLUS;
+            else if (*format == ' ') flags |= ARGUS_FORMAT_SPACE;
+            else if (*format == '#') flags |= ARGUS_FORMAT_ALT;
+            else break;
+        }
+        int width = 0;
+        if (*format == '*') {
+            width = va_arg(ap, int);
+            if (width < 0) {
+                flags |= ARGUS_FORMAT_LEFT;
+                width = -width;
             }
-#undef OPTIONAL_ARG
-#undef BOOLEAN_ARG
-
-            continue;
+            format++;
+        }
+        for (; *format >= '0' && *format <= '9'; format++) width = width * 10 + (*format - '0');
+        int precision = -1;
+        if (*format == '.') {
+            format++;
+            precision = 0;
+            if (*format == '*') {
+                precision = va_arg(ap, int);
+                format++;
+            }
+            for (; *format >= '0' && *format <= '9'; format++) precision = precision * 10 + (*format - '0');
+        }
+        // Length modifiers, by the size of the argument they take
+        char size = 0;
+        for (; *format == 'h' || *format == 'l' || *format == 'z' || *format == 'j' || *format == 't' ||
+               *format == 'L';
+             format++) {
+            size = *format == 'l' && size == 'l' ? 'q' : *format;
         }
 
-        fprintf(stderr, "Error: Invalid argument '%s'\n", argv[i]);
-        return 1;
+        const char conversion = *format;
+        if (conversion == '\0') break;
+        format++;
+        char   body[72];
+        size_t length = 0;
+        switch (conversion) {
+            case 'd':
+            case 'i': {
+                intmax_t value;
+                if (size == 'q') value = va_arg(ap, long long);
+                else if (size == 'l') value = va_arg(ap, long);
+                else if (size == 'z' || size == 't') value = va_arg(ap, ptrdiff_t);
+                else if (size == 'j') value = va_arg(ap, intmax_t);
+                else value = va_arg(ap, int);
+                const uintmax_t magnitude = value < 0 ? 0 - (uintmax_t)value : (uintmax_t)value;
+                if (precision >= 0) flags &= ~ARGUS_FORMAT_ZERO;
+                if (!(precision == 0 && value == 0)) {
+                    length = argus_format_digits(body, magnitude, 10, false, precision < 1 ? 1 : precision);
+                }
+                const char* sign = value < 0                     ? "-"
+                                   : (flags & ARGUS_FORMAT_PLUS)  ? "+"
+                                   : (flags & ARGUS_FORMAT_SPACE) ? " "
+                                                                  : "";
+                argus_sink_field(sink, sign, body, length, width, flags);
+                break;
+            }
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+            case 'p': {
+                uintmax_t value;
+                const char* prefix = "";
+                if (conversion == 'p') value = (uintptr_t)va_arg(ap, void*);
+                else if (size == 'q') value = va_arg(ap, unsigned long long);
+                else if (size == 'l') value = va_arg(ap, unsigned long);
+                else if (size == 'z' || size == 't') value = va_arg(ap, size_t);
+                else if (size == 'j') value = va_arg(ap, uintmax_t);
+                else value = va_arg(ap, unsigned int);
+                const unsigned base = conversion == 'u' ? 10 : conversion == 'o' ? 8 : 16;
+                if (conversion == 'p' || ((flags & ARGUS_FORMAT_ALT) && base == 16 && value != 0)) {
+                    prefix = conversion == 'X' ? "0X" : "0x";
+                }
+                if (precision >= 0) flags &= ~ARGUS_FORMAT_ZERO;
+                if (!(precision == 0 && value == 0)) {
+                    length = argus_format_digits(body, value, base, conversion == 'X', precision < 1 ? 1 : precision);
+                }
+                if ((flags & ARGUS_FORMAT_ALT) && base == 8 && (length == 0 || body[0] != '0')) prefix = "0";
+                argus_sink_field(sink, prefix, body, length, width, flags);
+                break;
+            }
+            case 'c':
+                body[0] = (char)va_arg(ap, int);
+                argus_sink_field(sink, "", body, 1, width, flags & ~ARGUS_FORMAT_ZERO);
+                break;
+            case 's': {
+                const char* text = va_arg(ap, const char*);
+                if (text == NULL) text = "(null)";
+                size_t text_length = 0;
+                while ((precision < 0 || text_length < (size_t)precision) && text[text_length] != '\0') text_length++;
+                argus_sink_field(sink, "", text, text_length, width, flags & ~ARGUS_FORMAT_ZERO);
+                break;
+            }
+            case 'e':
+            case 'E':
+            case 'f':
+            case 'F':
+            case 'g':
+            case 'G': {
+                const long double value = size == 'L' ? va_arg(ap, long double) : (long double)va_arg(ap, double);
+                argus_format_float(sink, value, conversion, precision, width, flags);
+                break;
+            }
+            case '%':
+                argus_sink_put(sink, "%", 1);
+                break;
+            default:
+                // Unknown conversions are written as they are
+                argus_sink_put(sink, "%", 1);
+                argus_sink_put(sink, &conversion, 1);
+                break;
+        }
     }
+}
 
-    return 0;
+// Same as vsnprintf
+static inline int argus_vsnprintf(char* dest, size_t space, const char* format, va_list ap) {
+    argus_sink_t sink = {dest, space > 0 ? space - 1 : 0, 0, -1};
+    argus_vformat(&sink, format, ap);
+    if (space > 0) dest[sink.length < space - 1 ? sink.length : space - 1] = '\0';
+    return (int)sink.length;
 }
+#define ARGUS_VSNPRINTF argus_vsnprintf
 
-// Display help string, given command used to launch program, e.g., argv[0]
-static inline void print_help(const char* exec_alias) {
-    // USAGE SECTION
-    printf("USAGE:\n");
-    printf("    %s ", exec_alias);
+static inline void argus_vprint(int stream, const char* format, va_list ap) {
+    char         buffer[256];
+    argus_sink_t sink = {buffer, sizeof(buffer), 0, stream};
+    argus_vformat(&sink, format, ap);
+    argus_sink_flush(&sink);
+}
 
-#define REQUIRED_ARG(type, name, label, ...) "<" label "> "
+static inline void argus_write_text(int stream, const char* text, size_t length) {
+    if (length > 0) ARGUS_WRITE(stream, text, length);
+}
 
-#ifdef REQUIRED_ARGS
-    if (REQUIRED_ARG_COUNT > 0 && REQUIRED_ARG_COUNT <= 3) {
-        printf(REQUIRED_ARGS);
-    } else {
-        printf("<ARGUMENTS> ");
-    }
-#endif
-#undef REQUIRED_ARG
+// Nothing is buffered
+static inline void argus_flush(int stream) {
+    (void)stream;
+}
+#else
+#define ARGUS_VSNPRINTF vsnprintf
 
-#define SHORT_OPT_QUICK_HELP(shortopt, arg_label) \
-    "[-" #shortopt "<" arg_label                  \
-    ">"                                           \
-    "] "
-#define OPTIONAL_ARG(type, name, shortopt, longopt, arg_label, ...) \
-    NOT_NONE(shortopt, SHORT_OPT_QUICK_HELP)(shortopt, arg_label)
+static inline void argus_vprint(int stream, const char* format, va_list ap) {
+    vfprintf(stream == ARGUS_STDOUT ? stdout : stderr, format, ap);
+}
 
-#define BOOLEAN_ARG_QUICK_HELP(shortopt) "[-" #shortopt "] "
-#define BOOLEAN_ARG(name, shortopt, longopt, ...) NOT_NONE(shortopt, BOOLEAN_ARG_QUICK_HELP)(shortopt)
+static inline void argus_write_text(int stream, const char* text, size_t length) {
+    fwrite(text, 1, length, stream == ARGUS_STDOUT ? stdout : stderr);
+}
 
-#if (OPTIONAL_ARG_COUNT + BOOLEAN_ARG_COUNT <= 3)
-#ifdef OPTIONAL_ARGS
-    printf(OPTIONAL_ARGS);
+static inline void argus_flush(int stream) {
+    fflush(stream == ARGUS_STDOUT ? stdout : stderr);
+}
 #endif
-#undef OPTIONAL_ARG
 
-#ifdef BOOLEAN_ARGS
-    printf(BOOLEAN_ARGS);
-#endif
-#undef BOOLEAN_ARG
+// Print formatted text to stream
+static inline void argus_print(int stream, const char* format, ...) {
+    va_list ap;
+    va_start(ap, format);
+    argus_vprint(stream, format, ap);
+    va_end(ap);
+}
 
-#else
-    printf("[OPTIONS]");
-#endif
+static inline void argus_print_char(int stream, char c) {
+    argus_write_text(stream, &c, 1);
+}
 
-    printf("\n\n");
+// ERRORS
+typedef enum {
+    ARGUS_OK = 0,
+    ARGUS_ERROR_PARSER,              // A custom parser rejected the value, it's expected to notify the user itself
+    ARGUS_ERROR_INVALID_VALUE,       // The value isn't a number of the expected type
+    ARGUS_ERROR_OUT_OF_RANGE,        // The value doesn't fit into its type
+    ARGUS_ERROR_TRAILING_CHARACTERS, // Only part of the value could be parsed
+    ARGUS_ERROR_MISSING_VALUE,       // An option wasn't followed by its value
+    ARGUS_ERROR_MISSING_REQUIRED,    // There are fewer arguments than required ones
+    ARGUS_ERROR_INVALID_FLAG,        // A short flag doesn't match any option
+    ARGUS_ERROR_INVALID_ARGUMENT,    // An argument doesn't match any option
+    ARGUS_ERROR_NULL_ARGV,           // argc or argv is zero
+    ARGUS_ERROR_NO_MEMORY,           // An allocation failed
+    ARGUS_ERROR_NO_STORAGE,          // The storage passed for repeated arguments is too small
+    ARGUS_ERROR_RESPONSE_FILE,       // A response file couldn't be read
+    ARGUS_ERROR_UNTERMINATED_QUOTE,  // A response file or line has an unterminated quote
+    ARGUS_ERROR_TOO_MANY_ARGUMENTS,  // Response files expand into too many arguments, or a line into too many tokens
+    ARGUS_ERROR_MISSING_COMMAND,     // No command was given to parse_command()
+    ARGUS_ERROR_UNKNOWN_COMMAND,     // The first argument doesn't name any command
+    ARGUS_ERROR_CONFIG_FILE,         // A config file couldn't be read
+    ARGUS_ERROR_CONFIG_SYNTAX,       // A line of a config file isn't of the form "key = value"
+    ARGUS_ERROR_UNKNOWN_KEY,         // A key of a config file doesn't match any optional or boolean argument
+    ARGUS_ERROR_BAD_SNAPSHOT,        // A snapshot is truncated, corrupt or was taken of another args_t
+    ARGUS_ERROR_NOT_REPRESENTABLE,   // The value of a custom parser can't be turned back into an argument
+    ARGUS_ERROR_AMBIGUOUS_OPTION,    // An abbreviated long option is the prefix of several options
+    ARGUS_ERROR_UNEXPECTED_VALUE,    // A boolean long option was given a value with '='
+} argus_error_code_t;
 
-    // Get maximum width of labels for spacing
-    int max_width = 0;
-    (void)max_width;  // suppress unused variable warning
+// Details about why parsing failed
+typedef struct {
+    argus_error_code_t code;
+    int index;             // Index of the offending argument in argv or line of a config file, -1 if there is none
+    const char* argument;  // The offending argument, it may come from a response file, NULL if there is none
+    size_t offset;         // Offset of the problem in bytes, from the start of argument
+    const char* option;    // Option the error belongs to as written on the command line, e.g. "--threads"
+    const char* value_type; // Type the value should have been parsed as, e.g. "int"
+} argus_error_t;
 
-#define REQUIRED_ARG(type, name, label, ...)  \
-    {                                         \
-        int len = strlen(label) + 2;          \
-        if (len > max_width) max_width = len; \
+// Print the message parse_args() prints for err to stderr
+static inline void argus_print_error(const argus_error_t* err) {
+    const char* argument = err->argument != NULL ? err->argument : "";
+    const char* at       = argument + (err->argument != NULL ? err->offset : 0);
+    const char* option   = err->option != NULL ? err->option : "";
+    const char* type     = err->value_type != NULL ? err->value_type : "";
+    switch (err->code) {
+        case ARGUS_OK:
+            break;
+        case ARGUS_ERROR_PARSER:
+            if (err->option != NULL) {
+                argus_print(ARGUS_STDERR, "Error: invalid value '%s' for option '%s'.\n", at, option);
+            } else {
+                argus_print(ARGUS_STDERR, "Error: invalid value '%s'.\n", at);
+            }
+            break;
+        case ARGUS_ERROR_INVALID_VALUE:
+            argus_print(ARGUS_STDERR, "Error: failed to parse '%s' as %s\n", at, type);
+            break;
+        case ARGUS_ERROR_OUT_OF_RANGE:
+            argus_print(ARGUS_STDERR, "Error: '%s' is out of range for %s\n", at, type);
+            break;
+        case ARGUS_ERROR_TRAILING_CHARACTERS:
+            if (err->option != NULL) {
+                argus_print(ARGUS_STDERR, "Error: couldn't parse argument '%s' for option '%s'.\n", argument, option);
+            } else {
+                argus_print(ARGUS_STDERR, "Error: couldn't parse argument '%s'.\n", argument);
+            }
+            break;
+        case ARGUS_ERROR_MISSING_VALUE:
+            argus_print(ARGUS_STDERR, "Error: option '%s' requires a value.\n", option);
+            break;
+        case ARGUS_ERROR_MISSING_REQUIRED:
+            argus_print(ARGUS_STDERR, "Not all required arguments included.\n");
+            break;
+        case ARGUS_ERROR_INVALID_FLAG:
+            argus_print(ARGUS_STDERR, "Error: Invalid flag '-%s'\n", at);
+            break;
+        case ARGUS_ERROR_INVALID_ARGUMENT:
+            argus_print(ARGUS_STDERR, "Error: Invalid argument '%s'\n", argument);
+            break;
+        case ARGUS_ERROR_NULL_ARGV:
+            argus_print(ARGUS_STDERR, "Internal error: null args or argv.\n");
+            break;
+        case ARGUS_ERROR_NO_MEMORY:
+            argus_print(ARGUS_STDERR, "Error: out of memory.\n");
+            break;
+        case ARGUS_ERROR_NO_STORAGE:
+            argus_print(ARGUS_STDERR, "Error: not enough storage for repeated arguments.\n");
+            break;
+        case ARGUS_ERROR_RESPONSE_FILE:
+            argus_print(ARGUS_STDERR, "Error: couldn't read response file '%s'.\n", at);
+            break;
+        case ARGUS_ERROR_UNTERMINATED_QUOTE:
+            if (err->argument != NULL) {
+                argus_print(ARGUS_STDERR, "Error: unterminated quote in response file '%s'.\n", at);
+            } else {
+                argus_print(ARGUS_STDERR, "Error: unterminated quote.\n");
+            }
+            break;
+        case ARGUS_ERROR_TOO_MANY_ARGUMENTS:
+            argus_print(ARGUS_STDERR, "Error: too many arguments.\n");
+            break;
+        case ARGUS_ERROR_MISSING_COMMAND:
+            argus_print(ARGUS_STDERR, "Error: missing command.\n");
+            break;
+        case ARGUS_ERROR_UNKNOWN_COMMAND:
+            argus_print(ARGUS_STDERR, "Error: Unknown command '%s'\n", argument);
+            break;
+        case ARGUS_ERROR_CONFIG_FILE:
+            argus_print(ARGUS_STDERR, "Error: couldn't read config file '%s'.\n", argument);
+            break;
+        case ARGUS_ERROR_CONFIG_SYNTAX:
+            argus_print(ARGUS_STDERR, "Error: expected 'key = value' on line %d of the config file.\n", err->index);
+            break;
+        case ARGUS_ERROR_UNKNOWN_KEY:
+            argus_print(ARGUS_STDERR, "Error: Unknown key '%s' on line %d of the config file.\n", option, err->index);
+            break;
+        case ARGUS_ERROR_BAD_SNAPSHOT:
+            argus_print(ARGUS_STDERR, "Error: invalid argument snapshot.\n");
+            break;
+        case ARGUS_ERROR_NOT_REPRESENTABLE:
+            argus_print(ARGUS_STDERR, "Error: the value of option '%s' can't be written as an argument.\n", option);
+            break;
+        case ARGUS_ERROR_AMBIGUOUS_OPTION:
+            argus_print(ARGUS_STDERR, "Error: Ambiguous option '%s'\n", argument);
+            break;
+        case ARGUS_ERROR_UNEXPECTED_VALUE:
+            argus_print(ARGUS_STDERR, "Error: option '%s' doesn't take a value.\n", option);
+            break;
+    }
+}
+
+// Built-in parsers return why they failed, anything else comes from a custom parser
+static inline argus_error_code_t argus_value_error(const int error) {
+    switch (error) {
+        case ARGUS_ERROR_INVALID_VALUE:
+        case ARGUS_ERROR_OUT_OF_RANGE:
+        case ARGUS_ERROR_NO_MEMORY:
+            return (argus_error_code_t)error;
+        default:
+            return ARGUS_ERROR_PARSER;
+    }
+}
+
+// INSTRUMENTATION
+// ARGUS_ON_OPTION(name, argv_index) and ARGUS_ON_ERROR(err) may be defined before the first inclusion. The first is
+// called with the bare name of every option parse_args() matches, the second with every error before it's returned.
+// Left undefined they generate no code.
+#ifdef ARGUS_ON_ERROR
+#define ARGUS_REPORT_ERROR(err) ARGUS_ON_ERROR(err)
+#else
+#define ARGUS_REPORT_ERROR(err) ((void)0)
+#endif
+
+// Record an error and leave the parser
+#define ARGUS_FAIL(...)                      \
+    do {                                     \
+        *err = (argus_error_t){__VA_ARGS__}; \
+        ARGUS_REPORT_ERROR(err);             \
+        return 1;                            \
+    } while (0)
+
+// PARSERS
+static inline int parse_str(const char* const text, char** out, const char** advance) {
+    *out = (char*)text;
+    if (advance != NULL) *advance = NULL;
+    return 0;
+}
+
+static inline int parse_char(const char* const text, char* out, const char** advance) {
+    // An empty value has no character to take, and stepping over its terminator would read past the string
+    if (text[0] == '\0') return ARGUS_ERROR_INVALID_VALUE;
+    *out = text[0];
+    if (advance != NULL) *advance = (char*)(text + 1);
+    return 0;
+}
+
+// Accepts true/false, yes/no, on/off and 1/0, used for boolean arguments in config files
+static inline int parse_bool(const char* const text, bool* out, const char** advance) {
+    static const char* const names[] = {"false", "true", "no", "yes", "off", "on", "0", "1"};
+    if (advance != NULL) *advance = NULL;
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (strcmp(text, names[i]) == 0) {
+            *out = (i % 2) == 1;
+            return 0;
+        }
+    }
+    return ARGUS_ERROR_INVALID_VALUE;
+}
+
+// Integer parsing result
+typedef enum {
+    ARGUS_INT_OK,
+    ARGUS_INT_NO_DIGITS,
+    ARGUS_INT_OVERFLOW,
+} argus_int_status_t;
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define ARGUS_SWAR_DIGITS
+// Convert 8 ASCII digits at once, see "Fast numeric string to int" by Daniel Lemire
+static inline uint32_t argus_swar_8_digits(const char* digits) {
+    uint64_t value;
+    memcpy(&value, digits, sizeof(value));
+    value -= 0x3030303030303030ull;
+    value = value * 10 + (value >> 8);
+    value = ((value & 0x000000FF000000FFull) * (100 + (1000000ull << 32)) +
+             ((value >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32))) >>
+            32;
+    return (uint32_t)value;
+}
+#endif
+
+// Whitespace as isspace() sees it in the C locale, which strtol and strtod skip before a number
+static inline bool argus_is_whitespace(const char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static inline int argus_hex_digit(const char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ * @brief Parse an optionally signed decimal or 0x prefixed hexadecimal magnitude
+ *
+ * Unlike strtoull this never looks at the locale or errno and reports overflow of 64 bits. Leading whitespace is
+ * skipped like strtoull does.
+ *
+ * @param[in]  text      Text to parse
+ * @param[out] magnitude Parsed value without its sign
+ * @param[out] negative  Whether the value had a minus sign
+ * @param[out] end       First character after the number
+ */
+static inline argus_int_status_t argus_parse_magnitude(const char* text, uint64_t* magnitude, bool* negative,
+                                                       const char** end) {
+    const char* c = text;
+    while (argus_is_whitespace(*c)) c++;
+    *negative = *c == '-';
+    if (*c == '-' || *c == '+') c++;
+
+    uint64_t value = 0;
+    if (c[0] == '0' && (c[1] == 'x' || c[1] == 'X') && argus_hex_digit(c[2]) >= 0) {
+        c += 2;
+        while (*c == '0') c++;
+        const char* digits = c;
+        for (int digit; (digit = argus_hex_digit(*c)) >= 0; c++) value = value << 4 | (uint64_t)digit;
+        *end       = c;
+        *magnitude = value;
+        return c - digits > 16 ? ARGUS_INT_OVERFLOW : ARGUS_INT_OK;
+    }
+
+    if (*c < '0' || *c > '9') {
+        *end = text;
+        return ARGUS_INT_NO_DIGITS;
+    }
+    while (*c == '0') c++;
+
+    // Find the digits first, so nothing past the end of the string is ever read
+    const char* digits = c;
+    while (*c >= '0' && *c <= '9') c++;
+    *end = c;
+
+    const size_t count = (size_t)(c - digits);
+    if (count > 20) return ARGUS_INT_OVERFLOW;
+
+    // At most 19 digits always fit into 64 bits, only a 20th one can overflow
+    const char* digit = digits;
+    const char* safe  = digits + (count == 20 ? 19 : count);
+#ifdef ARGUS_SWAR_DIGITS
+    for (; safe - digit >= 8; digit += 8) value = value * 100000000u + argus_swar_8_digits(digit);
+#endif
+    for (; digit < safe; digit++) value = value * 10 + (uint64_t)(*digit - '0');
+    if (count == 20) {
+        const uint64_t last = (uint64_t)(*digit - '0');
+        if (value > (UINT64_MAX - last) / 10) return ARGUS_INT_OVERFLOW;
+        value = value * 10 + last;
+    }
+    *magnitude = value;
+    return ARGUS_INT_OK;
+}
+
+#define UNSIGNED_PARSER(type, shorthand, max)                                                      \
+    static inline int parse_##shorthand(const char* const text, type* out, const char** advance) { \
+        uint64_t    magnitude;                                                                     \
+        bool        negative;                                                                      \
+        const char* end;                                                                           \
+        argus_int_status_t status = argus_parse_magnitude(text, &magnitude, &negative, &end);      \
+        if (status == ARGUS_INT_OK && ((negative && magnitude != 0) || magnitude > (max))) {       \
+            status = ARGUS_INT_OVERFLOW;                                                           \
+        }                                                                                          \
+        if (status == ARGUS_INT_NO_DIGITS) return ARGUS_ERROR_INVALID_VALUE;                       \
+        if (status == ARGUS_INT_OVERFLOW) return ARGUS_ERROR_OUT_OF_RANGE;                         \
+        *out = (type)magnitude;                                                                    \
+        if (advance != NULL) *advance = end;                                                       \
+        return 0;                                                                                  \
+    }
+
+#define SIGNED_PARSER(type, shorthand, max)                                                        \
+    static inline int parse_##shorthand(const char* const text, type* out, const char** advance) { \
+        uint64_t    magnitude;                                                                     \
+        bool        negative;                                                                      \
+        const char* end;                                                                           \
+        argus_int_status_t status = argus_parse_magnitude(text, &magnitude, &negative, &end);      \
+        if (status == ARGUS_INT_OK && magnitude > (uint64_t)(max) + negative) {                    \
+            status = ARGUS_INT_OVERFLOW;                                                           \
+        }                                                                                          \
+        if (status == ARGUS_INT_NO_DIGITS) return ARGUS_ERROR_INVALID_VALUE;                       \
+        if (status == ARGUS_INT_OVERFLOW) return ARGUS_ERROR_OUT_OF_RANGE;                         \
+        /* Negate in the unsigned domain first, so the minimum doesn't overflow */                 \
+        *out = negative && magnitude != 0 ? -(type)(magnitude - 1) - 1 : (type)magnitude;          \
+        if (advance != NULL) *advance = end;                                                       \
+        return 0;                                                                                  \
+    }
+
+// Decimal floating point literal split into its parts
+typedef struct {
+    uint64_t    mantissa;   // First 19 significant digits
+    long        exponent;   // Power of ten the mantissa is scaled by
+    bool        negative;   // Whether the literal had a minus sign
+    bool        truncated;  // Whether some significant digits didn't fit into the mantissa
+    const char* start;      // First character of the literal, after any leading whitespace
+    const char* end;        // First character after the literal
+} argus_decimal_t;
+
+typedef enum {
+    ARGUS_FLOAT_DECIMAL,  // Plain decimal literal, split into an argus_decimal_t
+    ARGUS_FLOAT_SPECIAL,  // Hexadecimal, infinity or NaN, left to strtod
+    ARGUS_FLOAT_INVALID,  // No digits at all
+} argus_float_form_t;
+
+// Split a decimal literal such as -12.5e3 into its parts, always using '.' as the radix. Leading whitespace is
+// skipped like strtod does.
+static inline argus_float_form_t argus_scan_decimal(const char* text, argus_decimal_t* out) {
+    const char* c = text;
+    while (argus_is_whitespace(*c)) c++;
+    out->start    = c;
+    out->negative = *c == '-';
+    if (*c == '-' || *c == '+') c++;
+
+    if ((c[0] == '0' && (c[1] == 'x' || c[1] == 'X')) || *c == 'i' || *c == 'I' || *c == 'n' || *c == 'N') {
+        return ARGUS_FLOAT_SPECIAL;
+    }
+
+    uint64_t mantissa  = 0;
+    int      stored    = 0;
+    long     exponent  = 0;
+    bool     any_digit = false;
+    bool     truncated = false;
+    bool     fraction  = false;
+    for (;; c++) {
+        if (*c >= '0' && *c <= '9') {
+            any_digit = true;
+            if (mantissa == 0 && *c == '0') {
+                // Leading zeros aren't significant
+            } else if (stored < 19) {
+                mantissa = mantissa * 10 + (uint64_t)(*c - '0');
+                stored++;
+            } else {
+                truncated |= *c != '0';
+                exponent++;
+            }
+            if (fraction) exponent--;
+        } else if (*c == '.' && !fraction) {
+            fraction = true;
+        } else {
+            break;
+        }
+    }
+    if (!any_digit) return ARGUS_FLOAT_INVALID;
+
+    // The exponent is only part of the literal if it has digits
+    if (*c == 'e' || *c == 'E') {
+        const char* e        = c + 1;
+        const bool  negative = *e == '-';
+        if (*e == '-' || *e == '+') e++;
+        if (*e >= '0' && *e <= '9') {
+            long value = 0;
+            for (; *e >= '0' && *e <= '9'; e++) {
+                if (value < 100000) value = value * 10 + (*e - '0');
+            }
+            exponent += negative ? -value : value;
+            c = e;
+        }
+    }
+
+    out->mantissa  = mantissa;
+    out->exponent  = exponent;
+    out->truncated = truncated;
+    out->end       = c;
+    return ARGUS_FLOAT_DECIMAL;
+}
+
+// Exact floating point arithmetic is needed for the fast paths to round correctly
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+#define ARGUS_FAST_FLOATS
+#endif
+
+#ifdef ARGUS_FAST_FLOATS
+static const double argus_pow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                     1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+#endif
+
+/**
+ * @brief Convert a decimal to a double if that takes a single correctly rounded operation
+ *
+ * Both the mantissa and a power of ten up to 1e22 are exact doubles, so one multiplication or division
+ * rounds the same way strtod does (Clinger's fast path). Anything else is left to the slow path.
+ */
+static inline bool argus_fast_d(const argus_decimal_t* decimal, double* out) {
+#ifdef ARGUS_FAST_FLOATS
+    uint64_t mantissa = decimal->mantissa;
+    long     exponent = decimal->exponent;
+    if (decimal->truncated) return false;
+    if (mantissa == 0) {
+        *out = decimal->negative ? -0.0 : 0.0;
+        return true;
+    }
+    // Move the excess of a large exponent into the mantissa while it stays exact
+    for (; exponent > 22 && mantissa <= (1ull << 53) / 10; exponent--) mantissa *= 10;
+    if (mantissa > 1ull << 53 || exponent < -22 || exponent > 22) return false;
+
+    double value = (double)mantissa;
+    value        = exponent < 0 ? value / argus_pow10[-exponent] : value * argus_pow10[exponent];
+    *out         = decimal->negative ? -value : value;
+    return true;
+#else
+    (void)decimal;
+    (void)out;
+    return false;
+#endif
+}
+
+// Same as argus_fast_d for floats, which hold powers of ten exactly up to 1e10
+static inline bool argus_fast_f(const argus_decimal_t* decimal, float* out) {
+#ifdef ARGUS_FAST_FLOATS
+    uint64_t mantissa = decimal->mantissa;
+    long     exponent = decimal->exponent;
+    if (decimal->truncated) return false;
+    if (mantissa == 0) {
+        *out = decimal->negative ? -0.0f : 0.0f;
+        return true;
+    }
+    for (; exponent > 10 && mantissa <= (1ull << 24) / 10; exponent--) mantissa *= 10;
+    if (mantissa > 1ull << 24 || exponent < -10 || exponent > 10) return false;
+
+    float value = (float)mantissa;
+    float scale = (float)argus_pow10[exponent < 0 ? -exponent : exponent];
+    value       = exponent < 0 ? value / scale : value * scale;
+    *out        = decimal->negative ? -value : value;
+    return true;
+#else
+    (void)decimal;
+    (void)out;
+    return false;
+#endif
+}
+
+// long double always goes through strtold
+static inline bool argus_fast_ld(const argus_decimal_t* decimal, long double* out) {
+    (void)decimal;
+    (void)out;
+    return false;
+}
+
+#ifdef ARGUS_NO_STDIO
+// Arbitrary precision unsigned integer for the exact slow path, in storage the caller sized for the largest value
+typedef struct {
+    uint32_t* limbs;  // Least significant first
+    size_t    count;  // Limbs in use, the most significant one is never zero
+} argus_big_t;
+
+// value = value * factor + addend
+static inline void argus_big_mul_add(argus_big_t* value, const uint32_t factor, const uint32_t addend) {
+    uint64_t carry = addend;
+    for (size_t i = 0; i < value->count; i++) {
+        carry += (uint64_t)value->limbs[i] * factor;
+        value->limbs[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+    if (carry != 0) value->limbs[value->count++] = (uint32_t)carry;
+}
+
+// value = value << bits
+static inline void argus_big_shift(argus_big_t* value, const size_t bits) {
+    const size_t limbs = bits / 32;
+    const int    shift = (int)(bits % 32);
+    if (value->count == 0) return;
+    if (shift != 0) {
+        uint32_t carry = 0;
+        for (size_t i = 0; i < value->count; i++) {
+            const uint32_t limb = value->limbs[i];
+            value->limbs[i]     = limb << shift | carry;
+            carry               = limb >> (32 - shift);
+        }
+        if (carry != 0) value->limbs[value->count++] = carry;
+    }
+    if (limbs != 0) {
+        memmove(value->limbs + limbs, value->limbs, value->count * sizeof(uint32_t));
+        memset(value->limbs, 0, limbs * sizeof(uint32_t));
+        value->count += limbs;
+    }
+}
+
+static inline int argus_big_compare(const argus_big_t* a, const argus_big_t* b) {
+    if (a->count != b->count) return a->count < b->count ? -1 : 1;
+    for (size_t i = a->count; i-- > 0;) {
+        if (a->limbs[i] != b->limbs[i]) return a->limbs[i] < b->limbs[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+// a = a - b, for a >= b
+static inline void argus_big_subtract(argus_big_t* a, const argus_big_t* b) {
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < a->count; i++) {
+        const uint64_t subtrahend = (i < b->count ? b->limbs[i] : 0) + borrow;
+        borrow                    = a->limbs[i] < subtrahend;
+        a->limbs[i]               = (uint32_t)((uint64_t)a->limbs[i] - subtrahend);
+    }
+    while (a->count > 0 && a->limbs[a->count - 1] == 0) a->count--;
+}
+
+static inline size_t argus_big_bits(const argus_big_t* value) {
+    if (value->count == 0) return 0;
+    size_t bits = (value->count - 1) * 32;
+    for (uint32_t top = value->limbs[value->count - 1]; top != 0; top >>= 1) bits++;
+    return bits;
+}
+
+// value * 2^exponent, exact whenever the result is representable
+static inline long double argus_scale_binary(long double value, long exponent) {
+    const long double step = 18446744073709551616.0L;  // 2^64
+    for (; exponent >= 64; exponent -= 64) value *= step;
+    for (; exponent <= -64; exponent += 64) value /= step;
+    return exponent < 0 ? value / (long double)(1ull << -exponent) : value * (long double)(1ull << exponent);
+}
+
+// Bits of precision and exponent range of every float type, by parser shorthand
+#define ARGUS_FLOAT_FORMAT_f FLT_MANT_DIG, FLT_MIN_EXP, FLT_MAX_EXP
+#define ARGUS_FLOAT_FORMAT_d DBL_MANT_DIG, DBL_MIN_EXP, DBL_MAX_EXP
+#define ARGUS_FLOAT_FORMAT_ld LDBL_MANT_DIG, LDBL_MIN_EXP, LDBL_MAX_EXP
+
+/**
+ * @brief Round a decimal literal correctly to a binary float type without strtod
+ *
+ * The digits of text are read again into big integers, so the value is exactly N / D times a power of two, with
+ * the power of five folded into N or D. Long division produces the bits the type keeps plus a rounding bit, and
+ * the remainder tells ties from values above them, so it rounds half to even like strtod. Digits past the longest
+ * halfway point between two values of the type can only break a tie and are replaced by a single 1. The result is
+ * representable in a type with the given precision and float.h exponent range, so storing it doesn't round again.
+ *
+ * @return 0, or ARGUS_ERROR_OUT_OF_RANGE where strtod sets ERANGE for overflow and underflow to zero
+ */
+static inline int argus_compose_decimal(const char* text, const argus_decimal_t* decimal, const int precision,
+                                        const int min_exp, const int max_exp, long double* out) {
+    *out = decimal->negative ? -0.0L : 0.0L;
+    if (decimal->mantissa == 0) return 0;
+
+    // The literal lies in [10^(point - 1), 10^point), rule out what is far outside the range of the type
+    long point = decimal->exponent;
+    for (uint64_t mantissa = decimal->mantissa; mantissa != 0; mantissa /= 10) point++;
+    if (point > (long)max_exp * 302 / 1000 + 2 || point < (long)(min_exp - precision) * 302 / 1000 - 2) {
+        return ARGUS_ERROR_OUT_OF_RANGE;
+    }
+
+    // A halfway point has at most k - floor(k log10 2) + digits(2^(precision + 1)) significant digits, where
+    // 2^-k is its lowest bit
+    const long  limit  = (long)(precision - min_exp + 1) * 7 / 10 + (long)(precision + 1) * 302 / 1000 + 4;
+    const char* digits = text + (*text == '-' || *text == '+');
+    long        count  = 0;
+    long        kept   = 0;
+    bool        sticky = false;
+    for (const char* c = digits; c < decimal->end && *c != 'e' && *c != 'E'; c++) {
+        if (*c == '.' || (count == 0 && *c == '0')) continue;
+        count++;
+        if (*c != '0' && count <= limit) kept = count;
+        if (*c != '0' && count > limit) sticky = true;
+    }
+    if (sticky) kept = limit;
+    // The value is N / D * 2^exponent, with N the kept digits times 5^exponent or D = 5^-exponent
+    const long exponent = point - kept - sticky;
+
+    // log2(10) < 10/3 and log2(5) < 7/3 bound the bits of N and D, leave room for normalizing and dividing
+    const long numerator_bits   = (kept + sticky) * 10 / 3 + 1 + (exponent > 0 ? exponent * 7 / 3 + 1 : 0);
+    const long denominator_bits = exponent < 0 ? -exponent * 7 / 3 + 1 : 1;
+    const size_t size = (size_t)(numerator_bits > denominator_bits ? numerator_bits : denominator_bits) / 32 + 3;
+    uint32_t     buffer[96];
+    uint32_t*    limbs = 2 * size <= 96 ? buffer : (uint32_t*)malloc(2 * size * sizeof(uint32_t));
+    if (limbs == NULL) return ARGUS_ERROR_NO_MEMORY;
+    argus_big_t numerator   = {limbs, 0};
+    argus_big_t denominator = {limbs + size, 1};
+    denominator.limbs[0]    = 1;
+
+    // Nine digits at a time
+    uint32_t group = 0;
+    uint32_t scale = 1;
+    count          = 0;
+    for (const char* c = digits; count < kept; c++) {
+        if (*c == '.' || (count == 0 && *c == '0')) continue;
+        group = group * 10 + (uint32_t)(*c - '0');
+        scale *= 10;
+        count++;
+        if (scale == 1000000000u) {
+            argus_big_mul_add(&numerator, scale, group);
+            group = 0;
+            scale = 1;
+        }
+    }
+    if (sticky) {
+        group = group * 10 + 1;
+        scale *= 10;
+    }
+    if (scale != 1) argus_big_mul_add(&numerator, scale, group);
+
+    // 5^13 is the largest power of five below 2^32
+    argus_big_t* powered = exponent > 0 ? &numerator : &denominator;
+    for (long left = exponent > 0 ? exponent : -exponent; left > 0; left -= 13) {
+        uint32_t power = 1;
+        for (long i = 0; i < left && i < 13; i++) power *= 5;
+        argus_big_mul_add(powered, power, 0);
+    }
+
+    // Normalize to 1 <= N / D < 2, so the value is in [2^(binary - 1), 2^binary)
+    long         binary           = exponent + 1;
+    const size_t numerator_size   = argus_big_bits(&numerator);
+    const size_t denominator_size = argus_big_bits(&denominator);
+    if (numerator_size < denominator_size) {
+        argus_big_shift(&numerator, denominator_size - numerator_size);
+        binary -= (long)(denominator_size - numerator_size);
+    } else {
+        argus_big_shift(&denominator, numerator_size - denominator_size);
+        binary += (long)(numerator_size - denominator_size);
+    }
+    if (argus_big_compare(&numerator, &denominator) < 0) {
+        argus_big_shift(&numerator, 1);
+        binary--;
+    }
+
+    // Subnormal values keep fewer bits, a value below half the smallest one rounds to zero
+    const long keep   = precision - (binary < min_exp ? min_exp - binary : 0);
+    int        status = binary > max_exp || keep < 0 ? ARGUS_ERROR_OUT_OF_RANGE : 0;
+    if (status == 0) {
+        long double value = 0.0L;
+        bool        odd   = false;
+        bool        ones  = true;
+        for (long bit = 0; bit < keep; bit++) {
+            const bool set = argus_big_compare(&numerator, &denominator) >= 0;
+            if (set) argus_big_subtract(&numerator, &denominator);
+            value = value * 2.0L + (set ? 1.0L : 0.0L);
+            odd   = set;
+            ones &= set;
+            argus_big_shift(&numerator, 1);
+        }
+        const bool half = argus_big_compare(&numerator, &denominator) >= 0;
+        if (half) argus_big_subtract(&numerator, &denominator);
+        if (half && (odd || numerator.count != 0)) {
+            value += 1.0L;
+            // Carrying out of the largest binade overflows
+            if (ones && keep == precision && binary == max_exp) status = ARGUS_ERROR_OUT_OF_RANGE;
+        }
+        if (value == 0.0L) status = ARGUS_ERROR_OUT_OF_RANGE;
+        value = argus_scale_binary(value, binary - keep);
+        if (status == 0) *out = decimal->negative ? -value : value;
+    }
+    if (limbs != buffer) free(limbs);
+    return status;
+}
+
+// Match "inf", "infinity" or "nan" in any case, after an optional sign
+static inline const char* argus_scan_special(const char* text, long double* out) {
+    const char* c        = text;
+    const bool  negative = *c == '-';
+    if (*c == '-' || *c == '+') c++;
+    static const char* const words[] = {"infinity", "inf", "nan"};
+    for (int word = 0; word < 3; word++) {
+        size_t length = 0;
+        while (words[word][length] != '\0' && (c[length] | 0x20) == words[word][length]) length++;
+        if (words[word][length] != '\0') continue;
+        const long double zero  = 0.0L;
+        const long double value = word == 2 ? zero / zero : 1.0L / zero;
+        *out                    = negative ? -value : value;
+        return c + length;
+    }
+    return NULL;
+}
+
+#define FLOAT_PARSER(type, shorthand, func)                                                                  \
+    static inline int parse_##shorthand(const char* const text, type* out, const char** advance) {           \
+        argus_decimal_t    decimal = {0};                                                                    \
+        argus_float_form_t form    = argus_scan_decimal(text, &decimal);                                     \
+        long double        value   = 0.0L;                                                                   \
+        const char*        end     = decimal.end;                                                            \
+        if (form == ARGUS_FLOAT_DECIMAL && argus_fast_##shorthand(&decimal, out)) {                          \
+            if (advance != NULL) *advance = decimal.end;                                                     \
+            return 0;                                                                                        \
+        }                                                                                                    \
+        if (form == ARGUS_FLOAT_SPECIAL) end = argus_scan_special(decimal.start, &value);                    \
+        if (form == ARGUS_FLOAT_INVALID || end == NULL) return ARGUS_ERROR_INVALID_VALUE;                    \
+        if (form == ARGUS_FLOAT_DECIMAL) {                                                                   \
+            const int error =                                                                                \
+                argus_compose_decimal(decimal.start, &decimal, ARGUS_FLOAT_FORMAT_##shorthand, &value);      \
+            if (error != 0) return error;                                                                    \
+        }                                                                                                    \
+        *out = (type)value;                                                                                  \
+        if (advance != NULL) *advance = end;                                                                 \
+        return 0;                                                                                            \
+    }
+#else
+/**
+ * @brief Copy a decimal literal without its radix point, moving the point into the exponent
+ *
+ * Digits and an exponent mean the same to strtod in every locale, unlike the radix, so "-12.5e3" is passed on as
+ * "-125e2" and LC_NUMERIC is never consulted. Returns buffer if the copy fits into buffer_size bytes, otherwise an
+ * allocation the caller has to free.
+ */
+static inline char* argus_unpoint_decimal(const char* text, const char* end, char* buffer, size_t buffer_size) {
+    // Room for the digits, the sign and "e-" followed by the longest exponent
+    const size_t needed = (size_t)(end - text) + 24;
+    char*        copy   = needed <= buffer_size ? buffer : (char*)malloc(needed);
+    if (copy == NULL) return NULL;
+
+    char*       out         = copy;
+    long        fraction    = 0;
+    bool        after_point = false;
+    const char* c           = text;
+    for (; c < end && *c != 'e' && *c != 'E'; c++) {
+        if (*c == '.') {
+            after_point = true;
+        } else {
+            fraction += after_point;
+            *out++ = *c;
+        }
+    }
+
+    // Same bound as argus_scan_decimal(), anything beyond is out of range either way
+    long exponent = 0;
+    if (c < end) {
+        const bool negative = c[1] == '-';
+        for (c += c[1] == '-' || c[1] == '+' ? 2 : 1; c < end; c++) {
+            if (exponent < 100000) exponent = exponent * 10 + (*c - '0');
+        }
+        if (negative) exponent = -exponent;
+    }
+    exponent -= fraction;
+
+    *out++ = 'e';
+    if (exponent < 0) *out++ = '-';
+    unsigned long magnitude = exponent < 0 ? 0ul - (unsigned long)exponent : (unsigned long)exponent;
+    char          digits[24];
+    int           count = 0;
+    do {
+        digits[count++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    while (count > 0) *out++ = digits[--count];
+    *out = '\0';
+    return copy;
+}
+
+#define FLOAT_PARSER(type, shorthand, func)                                                        \
+    static inline int parse_##shorthand(const char* const text, type* out, const char** advance) { \
+        argus_decimal_t    decimal = {0};                                                          \
+        argus_float_form_t form    = argus_scan_decimal(text, &decimal);                           \
+        if (form == ARGUS_FLOAT_DECIMAL && argus_fast_##shorthand(&decimal, out)) {                \
+            if (advance != NULL) *advance = decimal.end;                                           \
+            return 0;                                                                              \
+        }                                                                                          \
+        char        buffer[64];                                                                    \
+        char*       copy  = NULL;                                                                  \
+        char*       end   = NULL;                                                                  \
+        const char* input = decimal.start;                                                         \
+        if (form == ARGUS_FLOAT_DECIMAL) {                                                         \
+            copy = argus_unpoint_decimal(decimal.start, decimal.end, buffer, sizeof(buffer));      \
+            if (copy == NULL) return ARGUS_ERROR_NO_MEMORY;                                        \
+            input = copy;                                                                          \
+        }                                                                                          \
+        /* The caller's errno is left as it was */                                                 \
+        const int saved_errno = errno;                                                             \
+        errno                 = 0;                                                                 \
+        if (form != ARGUS_FLOAT_INVALID) *out = (type)func(input, &end);                           \
+        const bool parsed   = form != ARGUS_FLOAT_INVALID && end != input;                         \
+        const bool in_range = errno != ERANGE;                                                     \
+        errno               = saved_errno;                                                         \
+        if (copy != buffer) free(copy);                                                            \
+        if (!parsed) return ARGUS_ERROR_INVALID_VALUE;                                             \
+        if (!in_range) return ARGUS_ERROR_OUT_OF_RANGE;                                            \
+        if (advance != NULL) *advance = form == ARGUS_FLOAT_DECIMAL ? decimal.end : end;           \
+        return 0;                                                                                  \
+    }
+#endif
+
+UNSIGNED_PARSER(unsigned long long, ull, ULLONG_MAX)
+UNSIGNED_PARSER(unsigned long, ul, ULONG_MAX)
+SIGNED_PARSER(long long, ll, LLONG_MAX)
+SIGNED_PARSER(long, l, LONG_MAX)
+UNSIGNED_PARSER(unsigned int, uint, UINT_MAX)
+UNSIGNED_PARSER(size_t, size, SIZE_MAX)
+SIGNED_PARSER(int, int, INT_MAX)
+FLOAT_PARSER(float, f, strtof)
+FLOAT_PARSER(double, d, strtod)
+FLOAT_PARSER(long double, ld, strtold)
+
+// LIST PARSERS
+// Maximum number of values a list argument holds
+#ifndef ARGUS_LIST_CAPACITY
+#define ARGUS_LIST_CAPACITY 64
+#endif
+
+// Alignment of the values of a list argument, enough for 256 bit vector loads
+#ifndef ARGUS_LIST_ALIGNMENT
+#define ARGUS_LIST_ALIGNMENT 32
+#endif
+
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define ARGUS_ALIGNED(n) _Alignas(n)
+#elif defined(__GNUC__)
+#define ARGUS_ALIGNED(n) __attribute__((aligned(n)))
+#elif defined(_MSC_VER)
+#define ARGUS_ALIGNED(n) __declspec(align(n))
+#else
+#define ARGUS_ALIGNED(n)
+#endif
+
+// Whether two numbers differ for argus_diff(): 0.0 and -0.0 are equal, and so are two NaNs
+#define ARGUS_NUMBERS_DIFFER(a, b) ((a) != (b) && ((a) == (a) || (b) == (b)))
+
+// Every element parser stops at the first character that can't be part of its number, so the delimiters are found
+// by the same scan that converts the values. Lists differ if a value does, compared like ARGUS_NUMBERS_DIFFER.
+#define LIST_PARSER(type, shorthand, element)                                                           \
+    typedef struct {                                                                                    \
+        ARGUS_ALIGNED(ARGUS_LIST_ALIGNMENT) type values[ARGUS_LIST_CAPACITY];                           \
+        size_t count;                                                                                   \
+    } argus_##shorthand##_list_t;                                                                       \
+                                                                                                        \
+    static inline int parse_##shorthand##_list(const char* const text, argus_##shorthand##_list_t* out, \
+                                               const char** advance) {                                  \
+        out->count = 0;                                                                                 \
+        if (advance != NULL) *advance = NULL;                                                           \
+        if (*text == '\0') return 0;                                                                    \
+        for (const char* p = text;;) {                                                                  \
+            if (out->count == ARGUS_LIST_CAPACITY) return ARGUS_ERROR_OUT_OF_RANGE;                     \
+            const char* end = NULL;                                                                     \
+            int error       = parse_##element(p, &out->values[out->count], &end);                       \
+            if (error != 0) return error;                                                               \
+            out->count++;                                                                               \
+            if (end == NULL || *end == '\0') return 0;                                                  \
+            if (*end != ',') {                                                                          \
+                if (advance != NULL) *advance = end;                                                    \
+                return 0;                                                                               \
+            }                                                                                           \
+            p = end + 1;                                                                                \
+        }                                                                                               \
+    }                                                                                                   \
+                                                                                                        \
+    static inline bool argus_parse_##shorthand##_list_differs(const argus_##shorthand##_list_t* a,      \
+                                                              const argus_##shorthand##_list_t* b) {    \
+        if (a->count != b->count) return true;                                                          \
+        for (size_t i = 0; i < a->count; i++) {                                                         \
+            if (ARGUS_NUMBERS_DIFFER(a->values[i], b->values[i])) return true;                          \
+        }                                                                                               \
+        return false;                                                                                   \
+    }
+
+LIST_PARSER(int, int, int)
+LIST_PARSER(double, double, d)
+
+#if defined(ARGUS_RESPONSE_FILES) || defined(ARGUS_CONFIG_FILES)
+// FILE MAPPING
+typedef struct {
+    char* data;   // File contents followed by a writable NUL byte
+    size_t size;  // File size without the NUL byte
+    bool mapped;  // Whether data is a mapping rather than an allocation
+} argus_file_t;
+
+/**
+ * @brief Load a file into private memory, so it can be modified in place
+ *
+ * On POSIX systems the file is mapped copy-on-write instead of being read, so loading it costs one page fault per
+ * page that is touched. The NUL byte is the first byte past the end of the file in its last page, so a file that
+ * fills its last page exactly is read into an allocation instead.
+ *
+ * @param[in]  path Path of the file
+ * @param[out] file The loaded file
+ *
+ * @retval 1 Error
+ * @retval 0 OK
+ */
+static inline int argus_map_file(const char* path, argus_file_t* file) {
+#ifdef ARGUS_HAVE_MMAP
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return 1;
+    }
+    size_t size = (size_t)st.st_size;
+    char*  data = NULL;
+
+    // The tail of the last page past the end of the file reads as zeros and is private like the rest, mapping one
+    // byte more than the file makes it part of the data. There is no such tail when the file fills the page.
+    const long page = sysconf(_SC_PAGESIZE);
+    if (page > 0 && size % (size_t)page != 0) {
+        data = (char*)mmap(NULL, size + 1, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (data == (char*)MAP_FAILED) {
+            close(fd);
+            return 1;
+        }
+        file->mapped = true;
+    } else {
+        data = (char*)malloc(size + 1);
+        size_t done = 0;
+        while (data != NULL && done < size) {
+            const ssize_t n = read(fd, data + done, size - done);
+            if (n > 0) {
+                done += (size_t)n;
+            } else {
+                free(data);
+                data = NULL;
+            }
+        }
+        if (data == NULL) {
+            close(fd);
+            return 1;
+        }
+        data[size]   = '\0';
+        file->mapped = false;
+    }
+    close(fd);
+#elif defined(ARGUS_NO_STDIO)
+    // Files can only be read through mmap
+    char*  data = NULL;
+    size_t size = 0;
+    (void)path;
+    return 1;
+#else
+    FILE* fp = fopen(path, "rb");
+    if (fp == NULL) return 1;
+
+    long end = fseek(fp, 0, SEEK_END) == 0 ? ftell(fp) : -1;
+    if (end < 0 || fseek(fp, 0, SEEK_SET) != 0) {
+        fclose(fp);
+        return 1;
+    }
+    size_t size = (size_t)end;
+
+    char* data = (char*)malloc(size + 1);
+    if (data == NULL || fread(data, 1, size, fp) != size) {
+        free(data);
+        fclose(fp);
+        return 1;
+    }
+    fclose(fp);
+    data[size] = '\0';
+#endif
+    file->data = data;
+    file->size = size;
+    return 0;
+}
+
+// Release a file loaded with argus_map_file
+static inline void argus_unmap_file(argus_file_t* file) {
+#ifdef ARGUS_HAVE_MMAP
+    if (file->mapped) {
+        munmap(file->data, file->size + 1);
+    } else {
+        free(file->data);
+    }
+#else
+    free(file->data);
+#endif
+    file->data = NULL;
+    file->size = 0;
+}
+
+// A response or config file loaded into an args_t, whose string arguments may point into it
+typedef struct argus_loaded_file {
+    argus_file_t file;
+    struct argus_loaded_file* next;  // The file loaded before this one
+} argus_loaded_file_t;
+
+// Release every file of a list
+static inline void argus_release_files(argus_loaded_file_t** list) {
+    while (*list != NULL) {
+        argus_loaded_file_t* loaded = *list;
+        *list                       = loaded->next;
+        argus_unmap_file(&loaded->file);
+        free(loaded);
+    }
+}
+#endif
+
+// TOKENIZER
+static inline bool argus_is_space(char c) {
+    return argus_is_whitespace(c) || c == '\0';
+}
+
+// Whitespace within a line of a config file
+static inline bool argus_is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/**
+ * @brief Split a buffer into tokens in place
+ *
+ * Tokens are separated by whitespace. Single quotes keep everything up to the closing quote as is, double quotes
+ * group text but still allow backslash escapes, and a backslash outside of single quotes takes the next character
+ * literally. The tokens are written back to the start of the buffer as consecutive NUL terminated strings, so the
+ * n-th token starts right after the NUL of the previous one.
+ *
+ * @param[in,out] buf   The text to split. buf[len] must be writable.
+ * @param[in]     len   Length of the text
+ * @param[out]    count Number of tokens found
+ *
+ * @retval 1 Error (unterminated quote)
+ * @retval 0 OK
+ */
+static inline int argus_tokenize(char* buf, size_t len, size_t* count) {
+    const char* in = buf;
+    const char* const end = buf + len;
+    char* out = buf;  // Never overtakes in, as quotes, escapes and separators only shrink the text
+    size_t tokens = 0;
+
+    for (;;) {
+        while (in < end && argus_is_space(*in)) in++;
+        if (in == end) break;
+
+        char quote = '\0';
+        while (in < end) {
+            char c = *in;
+            if (quote == '\'') {
+                in++;
+                if (c == '\'') {
+                    quote = '\0';
+                } else {
+                    *out++ = c;
+                }
+            } else if (c == '\\' && in + 1 < end) {
+                if (in[1] != '\0') *out++ = in[1];
+                in += 2;
+            } else if (quote != '\0') {
+                in++;
+                if (c == quote) {
+                    quote = '\0';
+                } else {
+                    *out++ = c;
+                }
+            } else if (c == '"' || c == '\'') {
+                quote = c;
+                in++;
+            } else if (argus_is_space(c)) {
+                break;
+            } else {
+                *out++ = c;
+                in++;
+            }
+        }
+        if (quote != '\0') return 1;
+
+        // Step over the separator first, as the terminator may be written on top of it
+        if (in < end) in++;
+        *out++ = '\0';
+        tokens++;
+    }
+
+    *count = tokens;
+    return 0;
+}
+
+// ONE-TIME INITIALIZATION
+// Lookup tables that are built on first use are published with atomics, so threads parsing at the same time build
+// every table exactly once and afterwards only pay for an acquire load
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#define ARGUS_ATOMIC(type) _Atomic(type)
+#define ARGUS_LOAD_ACQUIRE(p) atomic_load_explicit(p, memory_order_acquire)
+#define ARGUS_STORE_RELEASE(p, value) atomic_store_explicit(p, value, memory_order_release)
+#define ARGUS_CAS(p, expected, desired) \
+    atomic_compare_exchange_strong_explicit(p, expected, desired, memory_order_acq_rel, memory_order_acquire)
+#define ARGUS_FETCH_ADD(p, value) atomic_fetch_add_explicit(p, value, memory_order_relaxed)
+#define ARGUS_HAVE_ATOMICS
+#elif defined(__GNUC__)
+#define ARGUS_ATOMIC(type) type
+#define ARGUS_LOAD_ACQUIRE(p) __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define ARGUS_STORE_RELEASE(p, value) __atomic_store_n(p, value, __ATOMIC_RELEASE)
+#define ARGUS_CAS(p, expected, desired) \
+    __atomic_compare_exchange_n(p, expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#define ARGUS_FETCH_ADD(p, value) __atomic_fetch_add(p, value, __ATOMIC_RELAXED)
+#define ARGUS_HAVE_ATOMICS
+#else
+// Without atomics the tables have to be built before threads start parsing, e.g. by parsing once up front
+#define ARGUS_ATOMIC(type) type
+#define ARGUS_LOAD_ACQUIRE(p) (*(p))
+#define ARGUS_STORE_RELEASE(p, value) (*(p) = (value))
+#define ARGUS_CAS(p, expected, desired) \
+    (*(p) == *(expected) ? (*(p) = (desired), true) : (*(expected) = *(p), false))
+#define ARGUS_FETCH_ADD(p, value) ((*(p) += (value)) - (value))
+#endif
+
+// Zero initialized, so a static argus_once_t starts out pending
+typedef ARGUS_ATOMIC(int) argus_once_t;
+enum { ARGUS_ONCE_PENDING, ARGUS_ONCE_RUNNING, ARGUS_ONCE_DONE };
+
+// Returns true for the one caller that has to initialize and then call argus_once_end(), every other caller
+// returns false once that is done
+static inline bool argus_once_begin(argus_once_t* once) {
+    if (ARGUS_LOAD_ACQUIRE(once) == ARGUS_ONCE_DONE) return false;
+    int expected = ARGUS_ONCE_PENDING;
+    if (ARGUS_CAS(once, &expected, ARGUS_ONCE_RUNNING)) return true;
+    while (ARGUS_LOAD_ACQUIRE(once) != ARGUS_ONCE_DONE) {
+        // Building a table takes microseconds, only the threads racing the very first parse wait here
+    }
+    return false;
+}
+
+static inline void argus_once_end(argus_once_t* once) {
+    ARGUS_STORE_RELEASE(once, ARGUS_ONCE_DONE);
+}
+
+// INSTRUMENTATION
+// The counters are bumped with relaxed atomic adds, so threads parsing at the same time don't lose counts
+#ifdef ARGUS_STATS
+#include <time.h>  // used for timing parsers
+
+// Counters shared by every argument set of the program, reset them by assigning (argus_stats_t){0} while no thread
+// is parsing
+typedef struct {
+    ARGUS_ATOMIC(uint64_t) tokens;        // Arguments scanned, sets with repeated arguments count them twice
+    ARGUS_ATOMIC(uint64_t) comparisons;   // Option names and flag characters compared with an argument
+    ARGUS_ATOMIC(uint64_t) parser_calls;  // Values given to a parser
+    ARGUS_ATOMIC(uint64_t) parser_ns;     // Time spent in parsers
+    ARGUS_ATOMIC(uint64_t) help_renders;  // Renders of the help text, cached text isn't rendered again
+    ARGUS_ATOMIC(uint64_t) help_ns;       // Time spent rendering help text
+} argus_stats_t;
+
+// Split headers keep a single copy of the counters in the ARGUS_IMPLEMENTATION file, like the functions
+#if defined(ARGUS_IMPLEMENTATION)
+#define ARGUS_STATS_STORAGE
+#elif defined(ARGUS_DECLARATIONS_ONLY)
+#define ARGUS_STATS_STORAGE extern
+#else
+#define ARGUS_STATS_STORAGE static
+#endif
+
+ARGUS_STATS_STORAGE argus_stats_t argus_stats;
+
+// A monotonic clock where POSIX provides one, processor time otherwise
+static inline uint64_t argus_now_ns(void) {
+#ifdef CLOCK_MONOTONIC
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+#else
+    return (uint64_t)((double)clock() * (1e9 / CLOCKS_PER_SEC));
+#endif
+}
+
+// Add the time since start to the parser totals and to the total of one argument
+static inline void argus_record_parse(ARGUS_ATOMIC(uint64_t)* argument_ns, const uint64_t start) {
+    const uint64_t elapsed = argus_now_ns() - start;
+    ARGUS_FETCH_ADD(argument_ns, elapsed);
+    ARGUS_FETCH_ADD(&argus_stats.parser_calls, 1);
+    ARGUS_FETCH_ADD(&argus_stats.parser_ns, elapsed);
+}
+
+#define ARGUS_COUNT(counter) ((void)ARGUS_FETCH_ADD(&argus_stats.counter, 1))
+#define ARGUS_ADD(counter, value) ((void)ARGUS_FETCH_ADD(&argus_stats.counter, value))
+#define ARGUS_COMPARE(test) (ARGUS_COUNT(comparisons), (test))
+// Declare error as the result of call, charging its time to the argument with the given id
+#define ARGUS_PARSE(error, id, call)               \
+    const uint64_t error##_start = argus_now_ns(); \
+    int error                    = call;           \
+    argus_record_parse(&argus_parse_ns[id], error##_start);
+#else
+#define ARGUS_COUNT(counter) ((void)0)
+#define ARGUS_ADD(counter, value) ((void)0)
+#define ARGUS_COMPARE(test) (test)
+#define ARGUS_PARSE(error, id, call) int error = call;
+#endif
+
+// UNIT PARSERS
+// A unit suffix and the number of base units it stands for
+typedef struct {
+    const char* suffix;
+    uint64_t    scale;
+} argus_unit_t;
+
+// K, M, G... and KiB, MiB, GiB... are powers of 1024, while kB, MB, GB... are powers of 1000. KB is 1024 like K.
+static const argus_unit_t argus_byte_units[] = {
+    {"KiB", 1ull << 10},
+    {"MiB", 1ull << 20},
+    {"GiB", 1ull << 30},
+    {"TiB", 1ull << 40},
+    {"PiB", 1ull << 50},
+    {"EiB", 1ull << 60},
+    {"kB", 1000ull},
+    {"KB", 1ull << 10},
+    {"MB", 1000000ull},
+    {"GB", 1000000000ull},
+    {"TB", 1000000000000ull},
+    {"PB", 1000000000000000ull},
+    {"EB", 1000000000000000000ull},
+    {"k", 1ull << 10},
+    {"K", 1ull << 10},
+    {"M", 1ull << 20},
+    {"G", 1ull << 30},
+    {"T", 1ull << 40},
+    {"P", 1ull << 50},
+    {"E", 1ull << 60},
+    {"B", 1ull},
+    {"", 1ull},
+};
+
+// Nanoseconds, a number without a unit counts seconds
+static const argus_unit_t argus_duration_units[] = {
+    {"ns", 1ull},
+    {"us", 1000ull},
+    {"ms", 1000000ull},
+    {"s", 1000000000ull},
+    {"min", 60000000000ull},
+    {"m", 60000000000ull},
+    {"h", 3600000000000ull},
+    {"d", 86400000000000ull},
+    {"", 1000000000ull},
+};
+
+/**
+ * @brief Parse a decimal number followed by a unit, e.g. 1.5GiB, in integer arithmetic
+ *
+ * The first unit whose suffix follows the number is taken, so longer suffixes have to come before their prefixes, and
+ * the last unit has the suffix "". Only 9 fraction digits are significant, the result is rounded down.
+ *
+ * @param[in]  text    Text to parse
+ * @param[in]  units   Units the number may be followed by
+ * @param[in]  max     Largest value that fits into the target
+ * @param[out] out     Parsed value in base units
+ * @param[out] advance First character after the unit, may be NULL
+ */
+static inline int argus_parse_scaled(const char* text, const argus_unit_t* units, uint64_t max, uint64_t* out,
+                                     const char** advance) {
+    const char* c = text;
+    while (argus_is_whitespace(*c)) c++;
+    const char* start    = c;
+    uint64_t    whole    = 0;
+    bool        overflow = false;
+    for (; *c >= '0' && *c <= '9'; c++) {
+        const uint64_t digit = (uint64_t)(*c - '0');
+        overflow |= whole > (UINT64_MAX - digit) / 10;
+        whole = whole * 10 + digit;
+    }
+    const bool has_whole = c != start;
+
+    uint64_t fraction = 0, denominator = 1;
+    if (*c == '.') {
+        const char* digits = ++c;
+        for (; *c >= '0' && *c <= '9'; c++) {
+            if (denominator < 1000000000ull) {
+                fraction = fraction * 10 + (uint64_t)(*c - '0');
+                denominator *= 10;
+            }
+        }
+        if (!has_whole && c == digits) return ARGUS_ERROR_INVALID_VALUE;
+    } else if (!has_whole) {
+        return ARGUS_ERROR_INVALID_VALUE;
+    }
+
+    const argus_unit_t* unit = units;
+    while (strncmp(c, unit->suffix, strlen(unit->suffix)) != 0) unit++;
+    c += strlen(unit->suffix);
+
+    // Split the scale by the denominator, so the fraction is scaled without overflowing
+    const uint64_t part = fraction * (unit->scale / denominator) + fraction * (unit->scale % denominator) / denominator;
+    if (overflow || (whole != 0 && whole > (max - part) / unit->scale) || part > max) return ARGUS_ERROR_OUT_OF_RANGE;
+    *out = whole * unit->scale + part;
+    if (advance != NULL) *advance = c;
+    return 0;
+}
+
+#ifdef __linux__
+// Read the first line of a small file
+static inline bool argus_read_first_line(const char* path, char* line, int size) {
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    const ssize_t length = read(fd, line, (size_t)size - 1);
+    close(fd);
+    if (length <= 0) return false;
+    line[length] = '\0';
+    char* newline = strchr(line, '\n');
+    if (newline != NULL) newline[1] = '\0';
+    return true;
+}
+
+// CPU quota of the cgroup mounted at /sys/fs/cgroup in processors, rounded up, or 0 if it has none
+static inline unsigned int argus_cgroup_cpus(void) {
+    char        line[64], period_line[64];
+    uint64_t    quota, period;
+    bool        negative;
+    const char* end;
+    // cgroup v2 has "<quota> <period>", where the quota is "max" without a limit
+    if (argus_read_first_line("/sys/fs/cgroup/cpu.max", line, sizeof(line))) {
+        if (argus_parse_magnitude(line, &quota, &negative, &end) != ARGUS_INT_OK || *end != ' ') return 0;
+        if (argus_parse_magnitude(end + 1, &period, &negative, &end) != ARGUS_INT_OK) return 0;
+    } else if (argus_read_first_line("/sys/fs/cgroup/cpu/cpu.cfs_quota_us", line, sizeof(line)) &&
+               argus_read_first_line("/sys/fs/cgroup/cpu/cpu.cfs_period_us", period_line, sizeof(period_line))) {
+        // cgroup v1 has the quota and the period in files of their own, the quota is -1 without a limit
+        if (argus_parse_magnitude(line, &quota, &negative, &end) != ARGUS_INT_OK || negative) return 0;
+        if (argus_parse_magnitude(period_line, &period, &negative, &end) != ARGUS_INT_OK) return 0;
+    } else {
+        return 0;
+    }
+    if (period == 0 || quota == 0 || quota / period >= UINT_MAX) return 0;
+    return (unsigned int)((quota + period - 1) / period);
+}
+#endif
+
+static argus_once_t argus_cpu_count_ready;
+static unsigned int argus_cpu_count_value;
+
+/**
+ * @brief Number of processors the process may keep busy at once, at least 1
+ *
+ * That's the online processors, on Linux limited by the CPU quota of the cgroup mounted at /sys/fs/cgroup. The count
+ * is worked out on first use, later calls return the same count.
+ */
+static inline unsigned int argus_cpu_count(void) {
+    if (argus_once_begin(&argus_cpu_count_ready)) {
+        unsigned int count = 1;
+#ifdef _SC_NPROCESSORS_ONLN
+        const long online = sysconf(_SC_NPROCESSORS_ONLN);
+        if (online > 0) count = (unsigned int)online;
+#endif
+#ifdef __linux__
+        const unsigned int quota = argus_cgroup_cpus();
+        if (quota > 0 && quota < count) count = quota;
+#endif
+        argus_cpu_count_value = count;
+        argus_once_end(&argus_cpu_count_ready);
+    }
+    return argus_cpu_count_value;
+}
+
+// Byte counts such as 4096, 64K, 1.5GiB or 10MB, see argus_byte_units
+static inline int parse_bytes(const char* const text, size_t* out, const char** advance) {
+    uint64_t  value;
+    const int error = argus_parse_scaled(text, argus_byte_units, SIZE_MAX, &value, advance);
+    if (error == 0) *out = (size_t)value;
+    return error;
+}
+
+// Durations such as 250ms, 1.5s or 2h into nanoseconds, see argus_duration_units
+static inline int parse_duration(const char* const text, unsigned long long* out, const char** advance) {
+    uint64_t  value;
+    const int error = argus_parse_scaled(text, argus_duration_units, ULLONG_MAX, &value, advance);
+    if (error == 0) *out = (unsigned long long)value;
+    return error;
+}
+
+// A thread count of 0 stands for one thread per processor, see argus_cpu_count(). Thread count arguments keep a
+// default of 0 as it is, so nothing is counted until the value is read through this.
+static inline unsigned int argus_resolve_threads(const unsigned int count) {
+    return count == 0 ? argus_cpu_count() : count;
+}
+
+// Thread counts, where "auto" and 0 resolve to one thread per processor
+static inline int parse_threads(const char* const text, unsigned int* out, const char** advance) {
+    if (strncmp(text, "auto", 4) == 0) {
+        *out = argus_cpu_count();
+        if (advance != NULL) *advance = text + 4;
+        return 0;
+    }
+    unsigned int count;
+    const int    error = parse_uint(text, &count, advance);
+    if (error == 0) *out = argus_resolve_threads(count);
+    return error;
+}
+
+// SHARED HELPERS
+// Conditional flag generation
+#define PROBE_NONE ,
+
+// This MUST be two steps to force the preprocessor to resolve the comma
+#define SELECT_3RD(a1, a2, a3, ...) a3
+#define EVAL_SELECT_3RD(args) SELECT_3RD args
+
+// Logic Selector
+#define DO_NOTHING(...)
+
+// Insert macro if value is not NONE
+#define NOT_NONE(val, MACRO) EVAL_SELECT_3RD((PROBE_##val, DO_NOTHING, MACRO))
+
+// Insert MACRO if value is not NONE, otherwise insert FALLBACK
+#define NOT_NONE_ELSE(val, MACRO, FALLBACK) EVAL_SELECT_3RD((PROBE_##val, FALLBACK, MACRO))
+
+// Insert MACRO if both values are NONE
+#define SKIP_SECOND(...) DO_NOTHING
+#define SECOND_NONE(second, MACRO) EVAL_SELECT_3RD((PROBE_##second, MACRO, DO_NOTHING))
+#define BOTH_NONE(first, second, MACRO) EVAL_SELECT_3RD((PROBE_##first, SECOND_NONE, SKIP_SECOND))(second, MACRO)
+
+// Insert MACRO if at least one of the values is not NONE
+#define TAKE_SECOND(second, MACRO) MACRO
+#define EITHER_SET(first, second, MACRO) EVAL_SELECT_3RD((PROBE_##first, NOT_NONE, TAKE_SECOND))(second, MACRO)
+
+// Smallest power of two that is greater or equal to x (for x <= 2^16)
+#define ARGUS_SMEAR_1(x) ((x) | (x) >> 1)
+#define ARGUS_SMEAR_2(x) (ARGUS_SMEAR_1(x) | ARGUS_SMEAR_1(x) >> 2)
+#define ARGUS_SMEAR_4(x) (ARGUS_SMEAR_2(x) | ARGUS_SMEAR_2(x) >> 4)
+#define ARGUS_SMEAR_8(x) (ARGUS_SMEAR_4(x) | ARGUS_SMEAR_4(x) >> 8)
+#define ARGUS_POW2_CEIL(x) (ARGUS_SMEAR_8((x) - 1) + 1)
+
+typedef struct {
+    const char* name;  // Long option without the leading "--" or NULL if the option has none
+    size_t len;
+} argus_name_t;
+
+// FNV-1a hash of a string up to stop or its NUL terminator, also returns the length that was hashed
+static inline uint32_t argus_hash_until(const char* str, char stop, size_t* len) {
+    uint32_t hash = 2166136261u;
+    const char* p = str;
+    for (; *p != '\0' && *p != stop; p++) {
+        hash = (hash ^ (unsigned char)*p) * 16777619u;
+    }
+    *len = (size_t)(p - str);
+    return hash;
+}
+
+// FNV-1a hash of a NUL terminated string, also returns its length
+static inline uint32_t argus_hash(const char* str, size_t* len) {
+    return argus_hash_until(str, '\0', len);
+}
+
+// Fill an open addressing table of (index + 1) for names, 0 marking an empty slot. mask is the number of slots
+// minus one. If two entries share a name the first one wins, like in the strcmp chain.
+static inline void argus_fill_slots(const argus_name_t* names, int count, unsigned short* slots, uint32_t mask) {
+    for (int id = 0; id < count; id++) {
+        if (names[id].name == NULL) continue;
+        size_t len;
+        uint32_t slot = argus_hash(names[id].name, &len) & mask;
+        while (slots[slot] != 0 && strcmp(names[slots[slot] - 1].name, names[id].name) != 0) {
+            slot = (slot + 1) & mask;
+        }
+        if (slots[slot] == 0) slots[slot] = (unsigned short)(id + 1);
+    }
+}
+
+// Look up the len bytes at key, which hash to hash, in a table filled by argus_fill_slots(). Returns the index of
+// the entry or -1.
+static inline int argus_probe_slots(const argus_name_t* names, const unsigned short* slots, uint32_t mask,
+                                    const char* key, size_t len, uint32_t hash) {
+    for (uint32_t slot = hash & mask; slots[slot] != 0; slot = (slot + 1) & mask) {
+        const argus_name_t* candidate = &names[slots[slot] - 1];
+        if (candidate->len == len && ARGUS_COMPARE(memcmp(candidate->name, key, len) == 0)) return slots[slot] - 1;
+    }
+    return -1;
+}
+
+// Returned by argus_walk_prefix() for a prefix of several names, none of which it spells out
+enum { ARGUS_AMBIGUOUS_ID = -2 };
+
+// Fill order with the indexes of the named entries, sorted by name. Entries sharing a name keep their order, so the
+// first one wins like in the strcmp chain. Returns the number of indexes written.
+static inline size_t argus_sort_names(const argus_name_t* names, int count, unsigned short* order) {
+    size_t sorted = 0;
+    for (int id = 0; id < count; id++) {
+        if (names[id].name == NULL) continue;
+        size_t j = sorted++;
+        for (; j > 0 && strcmp(names[order[j - 1]].name, names[id].name) > 0; j--) order[j] = order[j - 1];
+        order[j] = (unsigned short)id;
+    }
+    return sorted;
+}
+
+/**
+ * @brief Resolve key, a name or a unique prefix of one, in names sorted by argus_sort_names()
+ *
+ * The names starting with the first depth characters of key are a range of order. Each further character narrows it
+ * with two binary searches on that character alone, like a walk down a trie, so no name is compared more than once.
+ * A name that is spelled out wins over the longer names it's a prefix of.
+ *
+ * @param[in] key Name to resolve, it ends at its first '=' or NUL
+ * @param[out] value Set to the text after the '=' or to NULL if key has none
+ *
+ * @retval The index of the entry, -1 if no name starts with key or ARGUS_AMBIGUOUS_ID if several do
+ */
+static inline int argus_walk_prefix(const argus_name_t* names, const unsigned short* order, size_t count,
+                                    const char* key, const char** value) {
+    size_t low = 0, high = count, depth = 0;
+    for (; key[depth] != '\0' && key[depth] != '=' && low < high; depth++) {
+        const unsigned char c = (unsigned char)key[depth];
+        // Every name in the range is at least depth long, one that ends here has its NUL at depth and sorts first.
+        // If the first and the last name go on with c they all do, which skips shared stretches in two compares.
+        const unsigned char lowest = (unsigned char)names[order[low]].name[depth];
+        if (lowest == c && (unsigned char)names[order[high - 1]].name[depth] == c) continue;
+        size_t first = low, last = high;
+        while (first < last) {
+            const size_t mid = first + (last - first) / 2;
+            if ((unsigned char)names[order[mid]].name[depth] < c) {
+                first = mid + 1;
+            } else {
+                last = mid;
+            }
+        }
+        low  = first;
+        last = high;
+        while (first < last) {
+            const size_t mid = first + (last - first) / 2;
+            if ((unsigned char)names[order[mid]].name[depth] <= c) {
+                first = mid + 1;
+            } else {
+                last = mid;
+            }
+        }
+        high = first;
+    }
+    *value = key[depth] == '=' ? key + depth + 1 : NULL;
+    if (depth == 0 || low >= high) return -1;
+    if (high - low == 1 || names[order[low]].len == depth) return order[low];
+    return ARGUS_AMBIGUOUS_ID;
+}
+
+// Bytes needed to move address to a multiple of size, which is enough to align any of the argument types
+static inline size_t argus_padding(uintptr_t address, size_t size) {
+    size_t misalignment = (size_t)(address % size);
+    return misalignment == 0 ? 0 : size - misalignment;
+}
+
+// Maximum number of tokens parse_args_line() accepts, their pointers are kept on the stack
+#ifndef ARGUS_LINE_MAX_TOKENS
+#define ARGUS_LINE_MAX_TOKENS 256
+#endif
+
+#ifdef ARGUS_BATCH
+// Number of lines a thread of parse_args_batch() takes at a time
+#ifndef ARGUS_BATCH_CHUNK
+#define ARGUS_BATCH_CHUNK 512
+#endif
+
+// Upper bound on the threads of a single parse_args_batch() call
+#ifndef ARGUS_BATCH_MAX_THREADS
+#define ARGUS_BATCH_MAX_THREADS 256
+#endif
+#endif
+
+#ifdef ARGUS_RELOAD
+// Number of reader threads an args_reload_t can keep track of at a time
+#ifndef ARGUS_RELOAD_MAX_READERS
+#define ARGUS_RELOAD_MAX_READERS 64
+#endif
+
+// Readers announce quiescent points in slots of their own, a cache line apart
+#ifndef ARGUS_CACHE_LINE
+#define ARGUS_CACHE_LINE 64
+#endif
+
+// Value of a reader slot no thread has registered, it never holds up a reuse
+#define ARGUS_RELOAD_UNUSED UINT64_MAX
+#endif
+
+// Size of the static buffer help text is rendered into, longer texts are allocated once
+#ifndef ARGUS_HELP_BUFFER_SIZE
+#define ARGUS_HELP_BUFFER_SIZE 4096
+#endif
+
+// Help text rendered into a buffer
+typedef struct {
+    char*  data;
+    size_t size;    // Capacity of data in bytes
+    size_t length;  // Length of the text, may exceed size if the text didn't fit
+} argus_help_buffer_t;
+
+// Append formatted text to out, only counting what doesn't fit
+static inline void argus_help_append(argus_help_buffer_t* out, const char* format, ...) {
+    va_list ap;
+    va_start(ap, format);
+    char*  dest    = out->length < out->size ? out->data + out->length : NULL;
+    size_t space   = out->length < out->size ? out->size - out->length : 0;
+    int    written = ARGUS_VSNPRINTF(dest, space, format, ap);
+    va_end(ap);
+    if (written > 0) out->length += (size_t)written;
+}
+
+#define ARGUS_CONCAT_(a, b) a##b
+#define ARGUS_CONCAT(a, b) ARGUS_CONCAT_(a, b)
+
+// Where parse_args() found the value of an optional argument in ARGUS_LAZY mode
+typedef struct {
+    const char* argument;  // The argument holding the value, NULL if the option wasn't given
+    const char* value;     // The unparsed value inside argument, NULL once it has been parsed
+    const char* option;    // The option as it was given, e.g. "--threads"
+    int index;             // Index of argument in argv
+} argus_lazy_t;
+
+// What an argus_opt_desc_t describes
+typedef enum {
+    ARGUS_KIND_REQUIRED,
+    ARGUS_KIND_OPTIONAL,
+    ARGUS_KIND_BOOLEAN,
+    ARGUS_KIND_REPEATED,
+} argus_kind_t;
+
+// A parser behind an untyped value. A NULL value parses into a scratch value, which only checks the text.
+typedef int (*argus_value_parser_t)(const char* text, void* value, const char** advance);
+
+// One argument of an ARGUS_TABLE_DRIVEN set
+typedef struct {
+    const char* name;             // Name of the args_t member, e.g. "threads"
+    const char* longopt;          // Long option with its dashes, e.g. "--threads", NULL if it has none
+    const char* shortopt;         // Short option with its dash, e.g. "-t", NULL if it has none
+    const char* type;             // Declared type of the value, e.g. "unsigned int"
+    const char* label;            // Label of the value in help text
+    const char* default_text;     // Default value as declared, NULL for required and repeated arguments
+    const char* description;      // Help text of the argument
+    argus_kind_t kind;            // What kind of argument it is
+    int id;                       // ARGUS_ID_<name>, -1 for required arguments
+    size_t offset;                // Offset of the value in args_t, of the array pointer for repeated arguments and
+                                  // of the flag words for booleans in packed layout
+    size_t count_offset;          // Offset of <name>_count for repeated arguments
+    size_t size;                  // Size of one value
+    argus_value_parser_t parser;  // NULL for booleans
+} argus_opt_desc_t;
+
+// Built-in parsers are shared by every table entry using them, other parsers get a wrapper per argument
+#define ARGUS_UNTYPED_PARSER(type, parser)                                                          \
+    static inline int argus_untyped_##parser(const char* text, void* value, const char** advance) { \
+        type scratch;                                                                               \
+        return parser(text, value != NULL ? (type*)value : &scratch, advance);                      \
+    }
+ARGUS_UNTYPED_PARSER(char*, parse_str)
+ARGUS_UNTYPED_PARSER(char, parse_char)
+ARGUS_UNTYPED_PARSER(int, parse_int)
+ARGUS_UNTYPED_PARSER(unsigned int, parse_uint)
+ARGUS_UNTYPED_PARSER(long, parse_l)
+ARGUS_UNTYPED_PARSER(unsigned long, parse_ul)
+ARGUS_UNTYPED_PARSER(long long, parse_ll)
+ARGUS_UNTYPED_PARSER(unsigned long long, parse_ull)
+ARGUS_UNTYPED_PARSER(size_t, parse_size)
+ARGUS_UNTYPED_PARSER(size_t, parse_bytes)
+ARGUS_UNTYPED_PARSER(unsigned long long, parse_duration)
+ARGUS_UNTYPED_PARSER(unsigned int, parse_threads)
+ARGUS_UNTYPED_PARSER(float, parse_f)
+ARGUS_UNTYPED_PARSER(double, parse_d)
+ARGUS_UNTYPED_PARSER(long double, parse_ld)
+ARGUS_UNTYPED_PARSER(argus_int_list_t, parse_int_list)
+ARGUS_UNTYPED_PARSER(argus_double_list_t, parse_double_list)
+#define ARGUS_UNTYPED_parse_str ,
+#define ARGUS_UNTYPED_parse_char ,
+#define ARGUS_UNTYPED_parse_int ,
+#define ARGUS_UNTYPED_parse_uint ,
+#define ARGUS_UNTYPED_parse_l ,
+#define ARGUS_UNTYPED_parse_ul ,
+#define ARGUS_UNTYPED_parse_ll ,
+#define ARGUS_UNTYPED_parse_ull ,
+#define ARGUS_UNTYPED_parse_size ,
+#define ARGUS_UNTYPED_parse_bytes ,
+#define ARGUS_UNTYPED_parse_duration ,
+#define ARGUS_UNTYPED_parse_threads ,
+#define ARGUS_UNTYPED_parse_f ,
+#define ARGUS_UNTYPED_parse_d ,
+#define ARGUS_UNTYPED_parse_ld ,
+#define ARGUS_UNTYPED_parse_int_list ,
+#define ARGUS_UNTYPED_parse_double_list ,
+
+// ARGUS_PACKED_LAYOUT declares the values of args_t in passes of decreasing alignment, which is read off the parser
+// of every argument. Values of custom parsers and lists come first, as their alignment is unknown or the widest.
+#define ARGUS_SIZED_parse_ld ,
+#define ARGUS_SIZED_parse_str ,
+#define ARGUS_SIZED_parse_l ,
+#define ARGUS_SIZED_parse_ul ,
+#define ARGUS_SIZED_parse_ll ,
+#define ARGUS_SIZED_parse_ull ,
+#define ARGUS_SIZED_parse_size ,
+#define ARGUS_SIZED_parse_bytes ,
+#define ARGUS_SIZED_parse_duration ,
+#define ARGUS_SIZED_parse_d ,
+#define ARGUS_SIZED_parse_int ,
+#define ARGUS_SIZED_parse_uint ,
+#define ARGUS_SIZED_parse_threads ,
+#define ARGUS_SIZED_parse_f ,
+#define ARGUS_SIZED_parse_char ,
+#define ARGUS_ALIGN_WIDE_parse_ld ,
+#define ARGUS_ALIGN_WORD_parse_str ,
+#define ARGUS_ALIGN_WORD_parse_l ,
+#define ARGUS_ALIGN_WORD_parse_ul ,
+#define ARGUS_ALIGN_WORD_parse_ll ,
+#define ARGUS_ALIGN_WORD_parse_ull ,
+#define ARGUS_ALIGN_WORD_parse_size ,
+#define ARGUS_ALIGN_WORD_parse_bytes ,
+#define ARGUS_ALIGN_WORD_parse_duration ,
+#define ARGUS_ALIGN_WORD_parse_d ,
+#define ARGUS_ALIGN_HALF_parse_int ,
+#define ARGUS_ALIGN_HALF_parse_uint ,
+#define ARGUS_ALIGN_HALF_parse_threads ,
+#define ARGUS_ALIGN_HALF_parse_f ,
+#define ARGUS_ALIGN_BYTE_parse_char ,
+
+#define ARGUS_FIELD(type, name) type name;
+// Declare the value if its parser has no known alignment
+#define ARGUS_UNSIZED_FIELD(type, name, parser) \
+    EVAL_SELECT_3RD((ARGUS_SIZED_##parser, DO_NOTHING, ARGUS_FIELD))(type, name)
+// Declare the value if its parser belongs to pass, one of WIDE, WORD, HALF and BYTE
+#define ARGUS_PASS_FIELD(pass, type, name, parser) ARGUS_PASS_FIELD_(pass, type, name, parser)
+#define ARGUS_PASS_FIELD_(pass, type, name, parser) \
+    EVAL_SELECT_3RD((ARGUS_ALIGN_##pass##_##parser, ARGUS_FIELD, DO_NOTHING))(type, name)
+
+// Shells print_completion() writes scripts for
+typedef enum { ARGUS_SHELL_BASH, ARGUS_SHELL_ZSH, ARGUS_SHELL_FISH } argus_shell_t;
+
+// Print text inside single quotes, with a backslash in front of every character of escaped
+static inline void argus_print_escaped(const char* text, const char* escaped) {
+    for (; *text != '\0'; text++) {
+        if (*text == '\'') {
+            argus_print(ARGUS_STDOUT, "%s", "'\\''");
+            continue;
+        }
+        if (strchr(escaped, *text) != NULL) argus_print_char(ARGUS_STDOUT, '\\');
+        argus_print_char(ARGUS_STDOUT, *text);
+    }
+}
+
+// Print name with every character a shell function name can't hold replaced by '_'
+static inline void argus_print_identifier(const char* name) {
+    for (; *name != '\0'; name++) {
+        const char c = *name;
+        const bool kept = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+        argus_print_char(ARGUS_STDOUT, kept ? c : '_');
+    }
+}
+
+// Print the completion of an option for shell. The spellings include their dashes and are NULL if the option has
+// none, label is NULL for flags.
+static inline void argus_print_completion_option(argus_shell_t shell, const char* exec_name, const char* shortopt,
+                                                 const char* longopt, const char* description, const char* label,
+                                                 bool repeated) {
+    switch (shell) {
+        case ARGUS_SHELL_BASH:
+            break;  // bash asks the program itself, see complete_args()
+        case ARGUS_SHELL_ZSH:
+            // A short option takes its value in the same word, a long one in the next word
+            for (int i = 0; i < 2; i++) {
+                const char* spelling = i == 0 ? shortopt : longopt;
+                if (spelling == NULL) continue;
+                argus_print(ARGUS_STDOUT, "        '%s%s%s[", repeated ? "*" : "", spelling,
+                            label != NULL && i == 0 ? "-" : "");
+                argus_print_escaped(description, "[]:\\");
+                if (label != NULL) {
+                    argus_print(ARGUS_STDOUT, "%s", "]:");
+                    argus_print_escaped(label, ":\\");
+                    argus_print(ARGUS_STDOUT, "%s", ": ' \\\n");
+                } else {
+                    argus_print(ARGUS_STDOUT, "%s", "]' \\\n");
+                }
+            }
+            break;
+        case ARGUS_SHELL_FISH:
+            argus_print(ARGUS_STDOUT, "%s", "complete -c '");
+            argus_print_escaped(exec_name, "\\");
+            argus_print_char(ARGUS_STDOUT, '\'');
+            if (shortopt != NULL) argus_print(ARGUS_STDOUT, " -s %s", shortopt + 1);
+            if (longopt != NULL) argus_print(ARGUS_STDOUT, " -l %s", longopt + 2);
+            if (label != NULL) argus_print(ARGUS_STDOUT, "%s", " -r");
+            argus_print(ARGUS_STDOUT, "%s", " -d '");
+            argus_print_escaped(description, "\\");
+            argus_print(ARGUS_STDOUT, "%s", "'\n");
+            break;
+    }
+}
+
+// SNAPSHOTS
+// A snapshot is a header followed by every value in declaration order. Strings are stored as their length and their
+// bytes including the terminator, every other value as its bytes, so snapshots only move between builds of the
+// same program, which the layout field of the header checks.
+#define ARGUS_SNAPSHOT_MAGIC 0x53475241u  // "ARGS" in little endian
+#define ARGUS_SNAPSHOT_VERSION 1u
+#define ARGUS_NULL_STRING UINT64_MAX      // Length stored for NULL strings
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t layout;  // Size of args_t and a hash of the declarations
+    uint64_t size;    // Size of the whole snapshot in bytes
+} argus_snapshot_header_t;
+
+// Appends to a buffer, only counting what doesn't fit
+typedef struct {
+    unsigned char* data;
+    size_t size;
+    size_t length;
+} argus_writer_t;
+
+static inline void argus_write(argus_writer_t* out, const void* bytes, size_t n) {
+    if (out->length <= out->size && n <= out->size - out->length) memcpy(out->data + out->length, bytes, n);
+    out->length += n;
+}
+
+static inline void argus_write_string(argus_writer_t* out, const char* text) {
+    const uint64_t len = text == NULL ? ARGUS_NULL_STRING : (uint64_t)strlen(text);
+    argus_write(out, &len, sizeof(len));
+    if (text != NULL) argus_write(out, text, (size_t)len + 1);
+}
+
+typedef struct {
+    const unsigned char* data;
+    size_t size;
+    size_t offset;
+} argus_reader_t;
+
+static inline int argus_read(argus_reader_t* in, void* bytes, size_t n) {
+    if (n > in->size - in->offset) return 1;
+    memcpy(bytes, in->data + in->offset, n);
+    in->offset += n;
+    return 0;
+}
+
+// Strings point into the snapshot, which has to hold their terminator
+static inline int argus_read_string(argus_reader_t* in, char** out) {
+    uint64_t len;
+    if (argus_read(in, &len, sizeof(len)) != 0) return 1;
+    if (len == ARGUS_NULL_STRING) {
+        *out = NULL;
+        return 0;
+    }
+    if (len >= in->size - in->offset || in->data[in->offset + len] != '\0') return 1;
+    *out = (char*)(in->data + in->offset);
+    in->offset += (size_t)len + 1;
+    return 0;
+}
+
+static inline bool argus_strings_differ(const char* a, const char* b) {
+    if (a == NULL || b == NULL) return a != b;
+    return strcmp(a, b) != 0;
+}
+
+// Values of parse_str are strings, every other value is stored as its bytes
+#define ARGUS_STRING_parse_str ,
+#define ARGUS_WRITE_STRING(type, value) argus_write_string(&out, value);
+#define ARGUS_WRITE_BYTES(type, value) argus_write(&out, &(value), sizeof(type));
+#define ARGUS_WRITE_VALUE(type, value, parser) \
+    EVAL_SELECT_3RD((ARGUS_STRING_##parser, ARGUS_WRITE_STRING, ARGUS_WRITE_BYTES))(type, value)
+#define ARGUS_READ_STRING(type, target) \
+    if (argus_read_string(&in, target) != 0) ARGUS_FAIL(.code = ARGUS_ERROR_BAD_SNAPSHOT, .index = -1);
+#define ARGUS_READ_BYTES(type, target) \
+    if (argus_read(&in, target, sizeof(type)) != 0) ARGUS_FAIL(.code = ARGUS_ERROR_BAD_SNAPSHOT, .index = -1);
+#define ARGUS_READ_VALUE(type, target, parser) \
+    EVAL_SELECT_3RD((ARGUS_STRING_##parser, ARGUS_READ_STRING, ARGUS_READ_BYTES))(type, target)
+// Lists of a snapshot can't hold more values than fit
+#define ARGUS_CHECK_LIST(value) \
+    if ((value).count > ARGUS_LIST_CAPACITY) ARGUS_FAIL(.code = ARGUS_ERROR_BAD_SNAPSHOT, .index = -1);
+#define ARGUS_CHECK_VALUE(value, parser) EVAL_SELECT_3RD((ARGUS_LIST_##parser, ARGUS_CHECK_LIST, DO_NOTHING))(value)
+#define ARGUS_STRING_DIFFERS(a, b) argus_strings_differ(a, b)
+#define ARGUS_BYTES_DIFFER(a, b) (memcmp(&(a), &(b), sizeof(a)) != 0)
+#define ARGUS_VALUE_DIFFERS(a, b, parser) \
+    EVAL_SELECT_3RD((ARGUS_STRING_##parser, ARGUS_STRING_DIFFERS, ARGUS_BYTES_DIFFER))(a, b)
+
+// FIELD DIFFS
+// Strings are compared with strcmp, the built-in scalars and lists by their values with ARGUS_NUMBERS_DIFFER and
+// anything else by its bytes
+#define ARGUS_TEXT_DIFFERS(a, b, parser) argus_strings_differ(a, b)
+#define ARGUS_SCALAR_DIFFERS(a, b, parser) ARGUS_NUMBERS_DIFFER(a, b)
+#define ARGUS_LIST_DIFFERS(a, b, parser) argus_##parser##_differs(&(a), &(b))
+#define ARGUS_RAW_DIFFERS(a, b, parser) ARGUS_BYTES_DIFFER(a, b)
+#define ARGUS_OTHER_DIFFERS(a, b, parser) \
+    EVAL_SELECT_3RD((ARGUS_LIST_##parser, ARGUS_LIST_DIFFERS, ARGUS_RAW_DIFFERS))(a, b, parser)
+#define ARGUS_NUMBER_DIFFERS(a, b, parser) \
+    EVAL_SELECT_3RD((ARGUS_SIZED_##parser, ARGUS_SCALAR_DIFFERS, ARGUS_OTHER_DIFFERS))(a, b, parser)
+#define ARGUS_FIELD_DIFFERS(a, b, parser) \
+    EVAL_SELECT_3RD((ARGUS_STRING_##parser, ARGUS_TEXT_DIFFERS, ARGUS_NUMBER_DIFFERS))(a, b, parser)
+
+// Whether argus_diff() found the field with the given id, e.g. ARGUS_ID_threads, changed
+#define ARGUS_CHANGED(diff, id) ((((diff).bits[(id) / 64] >> ((id) % 64)) & 1) != 0)
+
+// CANONICAL ARGV
+// Formats that parse back to the same value, by parser
+#define ARGUS_FORMAT_parse_str "%s"
+#define ARGUS_FORMAT_parse_char "%c"
+#define ARGUS_FORMAT_parse_int "%d"
+#define ARGUS_FORMAT_parse_uint "%u"
+#define ARGUS_FORMAT_parse_l "%ld"
+#define ARGUS_FORMAT_parse_ul "%lu"
+#define ARGUS_FORMAT_parse_ll "%lld"
+#define ARGUS_FORMAT_parse_ull "%llu"
+#define ARGUS_FORMAT_parse_size "%zu"
+#define ARGUS_FORMAT_parse_bytes "%zu"
+#define ARGUS_FORMAT_parse_duration "%lluns"
+#define ARGUS_FORMAT_parse_threads "%u"
+#define ARGUS_FORMAT_parse_f "%.9g"
+#define ARGUS_FORMAT_parse_d "%.17g"
+#define ARGUS_FORMAT_parse_ld "%.21Lg"
+#define ARGUS_LIST_parse_int_list ,
+#define ARGUS_LIST_parse_double_list ,
+#define ARGUS_LIST_FORMAT_parse_int_list "%d"
+#define ARGUS_LIST_FORMAT_parse_double_list "%.17g"
+
+// Builds arguments into a single block, the first pass only measures them
+typedef struct {
+    char** argv;  // NULL while measuring
+    char* text;
+    size_t capacity;
+    size_t length;
+    size_t start;  // Offset of the argument being built
+    int argc;
+} argus_argv_builder_t;
+
+static inline void argus_argv_append(argus_argv_builder_t* out, const char* format, ...) {
+    va_list ap;
+    va_start(ap, format);
+    char*  dest    = out->argv != NULL ? out->text + out->length : NULL;
+    size_t space   = out->argv != NULL ? out->capacity - out->length : 0;
+    int    written = ARGUS_VSNPRINTF(dest, space, format, ap);
+    va_end(ap);
+    if (written > 0) out->length += (size_t)written;
+}
+
+static inline void argus_argv_end(argus_argv_builder_t* out) {
+    if (out->argv != NULL) {
+        out->text[out->length] = '\0';
+        out->argv[out->argc]   = out->text + out->start;
+    }
+    out->length++;
+    out->start = out->length;
+    out->argc++;
+}
+
+// Push a value onto the argument being built. Scalars use the format of their parser, lists are joined with ','
+// and values of custom parsers can't be represented.
+#define ARGUS_PUSH_TEXT(parser, value, spelling)                       \
+    argus_argv_append(&builder, "%s", (value) != NULL ? (value) : ""); \
+    argus_argv_end(&builder);
+#define ARGUS_PUSH_SCALAR(parser, value, spelling)             \
+    argus_argv_append(&builder, ARGUS_FORMAT_##parser, value); \
+    argus_argv_end(&builder);
+#define ARGUS_PUSH_LIST(parser, value, spelling)                                                          \
+    for (size_t k = 0; k < (value).count; k++) {                                                          \
+        argus_argv_append(&builder, k == 0 ? ARGUS_LIST_FORMAT_##parser : "," ARGUS_LIST_FORMAT_##parser, \
+                          (value).values[k]);                                                             \
+    }                                                                                                     \
+    argus_argv_end(&builder);
+#define ARGUS_PUSH_CUSTOM(parser, value, spelling) \
+    ARGUS_FAIL(.code = ARGUS_ERROR_NOT_REPRESENTABLE, .index = -1, .option = spelling);
+#define ARGUS_PUSH_UNSIZED(parser, value, spelling) \
+    EVAL_SELECT_3RD((ARGUS_LIST_##parser, ARGUS_PUSH_LIST, ARGUS_PUSH_CUSTOM))(parser, value, spelling)
+#define ARGUS_PUSH_SIZED(parser, value, spelling) \
+    EVAL_SELECT_3RD((ARGUS_SIZED_##parser, ARGUS_PUSH_SCALAR, ARGUS_PUSH_UNSIZED))(parser, value, spelling)
+#define ARGUS_PUSH_VALUE(parser, value, spelling) \
+    EVAL_SELECT_3RD((ARGUS_STRING_##parser, ARGUS_PUSH_TEXT, ARGUS_PUSH_SIZED))(parser, value, spelling)
+
+// The name of an option in messages, and pushing its spelling. A short one takes its value in the same argument.
+#define ARGUS_LONG_OPTION(shortopt, longopt) "--" #longopt
+#define ARGUS_SHORT_OPTION(shortopt, longopt) "-" #shortopt
+#define ARGUS_OPTION_NAME(shortopt, longopt) \
+    NOT_NONE_ELSE(longopt, ARGUS_LONG_OPTION, ARGUS_SHORT_OPTION)(shortopt, longopt)
+#define ARGUS_PUSH_LONG(shortopt, longopt)            \
+    argus_argv_append(&builder, "%s", "--" #longopt); \
+    argus_argv_end(&builder);
+#define ARGUS_PUSH_SHORT(shortopt, longopt) argus_argv_append(&builder, "%s", "-" #shortopt);
+#define ARGUS_PUSH_SHORT_FLAG(shortopt, longopt) \
+    ARGUS_PUSH_SHORT(shortopt, longopt)          \
+    argus_argv_end(&builder);
+
+#endif
+
+// ARGUMENT SETS
+// Everything below depends on the argument lists. Without ARGUS_PREFIX it's generated once. With ARGUS_PREFIX every
+// inclusion generates another set, in which every name is prefixed, e.g. ingest_args_t and ingest_parse_args().
+#if defined(ARGUS_PREFIX) || (!defined(ARGUS_ARGS_H) && !defined(COMMANDS))
+#ifdef ARGUS_PREFIX
+#define ARGUS_ID(name) ARGUS_CONCAT(ARGUS_PREFIX, ARGUS_CONCAT(ARGUS_ID_, name))
+#define ARGUS_GETTER(name) ARGUS_CONCAT(ARGUS_PREFIX, ARGUS_CONCAT(args_get_, name))
+#define ARGUS_SETTER(name) ARGUS_CONCAT(ARGUS_PREFIX, ARGUS_CONCAT(args_set_, name))
+#define ARGUS_WRAPPED(name) ARGUS_CONCAT(ARGUS_PREFIX, ARGUS_CONCAT(argus_wrapped_, name))
+#define REQUIRED_ARG_COUNT ARGUS_CONCAT(ARGUS_PREFIX, REQUIRED_ARG_COUNT)
+#define OPTIONAL_ARG_COUNT ARGUS_CONCAT(ARGUS_PREFIX, OPTIONAL_ARG_COUNT)
+#define BOOLEAN_ARG_COUNT ARGUS_CONCAT(ARGUS_PREFIX, BOOLEAN_ARG_COUNT)
+#define REPEATED_ARG_COUNT ARGUS_CONCAT(ARGUS_PREFIX, REPEATED_ARG_COUNT)
+#define args_t ARGUS_CONCAT(ARGUS_PREFIX, args_t)
+#define make_default_args ARGUS_CONCAT(ARGUS_PREFIX, make_default_args)
+#define free_args ARGUS_CONCAT(ARGUS_PREFIX, free_args)
+#define ARGUS_OPTION_COUNT ARGUS_CONCAT(ARGUS_PREFIX, ARGUS_OPTION_COUNT)
+#define ARGUS_FIELD_COUNT ARGUS_CONCAT(ARGUS_PREFIX, ARGUS_FIELD_COUNT)
+#define argus_diff_t ARGUS_CONCAT(ARGUS_PREFIX, argus_diff_t)
+#define argus_long_names ARGUS_CONCAT(ARGUS_PREFIX, argus_long_names)
+#define ARGUS_LONG_SLOTS ARGUS_CONCAT(ARGUS_PREFIX, ARGUS_LONG_SLOTS)
+#define argus_long_slots ARGUS_CONCAT(ARGUS_PREFIX, argus_long_slots)
+#define argus_long_slots_ready ARGUS_CONCAT(ARGUS_PREFIX, argus_long_slots_ready)
+#define argus_build_long_slots ARGUS_CONCAT(ARGUS_PREFIX, argus_build_long_slots)
+#define argus_find_long ARGUS_CONCAT(ARGUS_PREFIX, argus_find_long)
+#define argus_long_order ARGUS_CONCAT(ARGUS_PREFIX, argus_long_order)
+#define argus_long_order_count ARGUS_CONCAT(ARGUS_PREFIX, argus_long_order_count)
+#define argus_long_order_ready ARGUS_CONCAT(ARGUS_PREFIX, argus_long_order_ready)
+#define argus_build_long_order ARGUS_CONCAT(ARGUS_PREFIX, argus_build_long_order)
+#define argus_find_abbrev ARGUS_CONCAT(ARGUS_PREFIX, argus_find_abbrev)
+#define argus_short_ids ARGUS_CONCAT(ARGUS_PREFIX, argus_short_ids)
+#define argus_short_ids_ready ARGUS_CONCAT(ARGUS_PREFIX, argus_short_ids_ready)
+#define argus_build_short_ids ARGUS_CONCAT(ARGUS_PREFIX, argus_build_short_ids)
+#define argus_find_short ARGUS_CONCAT(ARGUS_PREFIX, argus_find_short)
+#define argus_parse_ns ARGUS_CONCAT(ARGUS_PREFIX, argus_parse_ns)
+#define argus_descriptors ARGUS_CONCAT(ARGUS_PREFIX, argus_descriptors)
+#define argus_descriptor_count ARGUS_CONCAT(ARGUS_PREFIX, argus_descriptor_count)
+#define argus_table_find_long ARGUS_CONCAT(ARGUS_PREFIX, argus_table_find_long)
+#define argus_table_find_short ARGUS_CONCAT(ARGUS_PREFIX, argus_table_find_short)
+#define argus_table_store ARGUS_CONCAT(ARGUS_PREFIX, argus_table_store)
+#define argus_table_set_flag ARGUS_CONCAT(ARGUS_PREFIX, argus_table_set_flag)
+#define argus_table_positional ARGUS_CONCAT(ARGUS_PREFIX, argus_table_positional)
+#define argus_scan ARGUS_CONCAT(ARGUS_PREFIX, argus_scan)
+#define argus_parse_argv ARGUS_CONCAT(ARGUS_PREFIX, argus_parse_argv)
+#define argus_parse_response_files ARGUS_CONCAT(ARGUS_PREFIX, argus_parse_response_files)
+#define argus_takes_next_value ARGUS_CONCAT(ARGUS_PREFIX, argus_takes_next_value)
+#define argus_follow_scan ARGUS_CONCAT(ARGUS_PREFIX, argus_follow_scan)
+#define parse_args_arena_ex ARGUS_CONCAT(ARGUS_PREFIX, parse_args_arena_ex)
+#define parse_args_ex ARGUS_CONCAT(ARGUS_PREFIX, parse_args_ex)
+#define parse_args_r ARGUS_CONCAT(ARGUS_PREFIX, parse_args_r)
+#define parse_args_arena ARGUS_CONCAT(ARGUS_PREFIX, parse_args_arena)
+#define parse_args ARGUS_CONCAT(ARGUS_PREFIX, parse_args)
+#define parse_args_line_ex ARGUS_CONCAT(ARGUS_PREFIX, parse_args_line_ex)
+#define parse_args_line ARGUS_CONCAT(ARGUS_PREFIX, parse_args_line)
+#define args_batch_t ARGUS_CONCAT(ARGUS_PREFIX, args_batch_t)
+#define argus_batch_layout ARGUS_CONCAT(ARGUS_PREFIX, argus_batch_layout)
+#define argus_batch_job_t ARGUS_CONCAT(ARGUS_PREFIX, argus_batch_job_t)
+#define argus_batch_lines ARGUS_CONCAT(ARGUS_PREFIX, argus_batch_lines)
+#define argus_batch_worker ARGUS_CONCAT(ARGUS_PREFIX, argus_batch_worker)
+#define parse_args_batch ARGUS_CONCAT(ARGUS_PREFIX, parse_args_batch)
+#define free_args_batch ARGUS_CONCAT(ARGUS_PREFIX, free_args_batch)
+#define args_reload_t ARGUS_CONCAT(ARGUS_PREFIX, args_reload_t)
+#define argus_reload_shadow ARGUS_CONCAT(ARGUS_PREFIX, argus_reload_shadow)
+#define argus_reload_drained ARGUS_CONCAT(ARGUS_PREFIX, argus_reload_drained)
+#define args_reload_init ARGUS_CONCAT(ARGUS_PREFIX, args_reload_init)
+#define args_reload_begin ARGUS_CONCAT(ARGUS_PREFIX, args_reload_begin)
+#define args_reload_publish ARGUS_CONCAT(ARGUS_PREFIX, args_reload_publish)
+#define args_reload_register ARGUS_CONCAT(ARGUS_PREFIX, args_reload_register)
+#define args_reload_read ARGUS_CONCAT(ARGUS_PREFIX, args_reload_read)
+#define args_reload_quiescent ARGUS_CONCAT(ARGUS_PREFIX, args_reload_quiescent)
+#define args_reload_unregister ARGUS_CONCAT(ARGUS_PREFIX, args_reload_unregister)
+#define free_args_reload ARGUS_CONCAT(ARGUS_PREFIX, free_args_reload)
+#define argus_render_help ARGUS_CONCAT(ARGUS_PREFIX, argus_render_help)
+#define argus_help_static ARGUS_CONCAT(ARGUS_PREFIX, argus_help_static)
+#define argus_help ARGUS_CONCAT(ARGUS_PREFIX, argus_help)
+#define argus_help_rendered_for ARGUS_CONCAT(ARGUS_PREFIX, argus_help_rendered_for)
+#define argus_help_alias_length ARGUS_CONCAT(ARGUS_PREFIX, argus_help_alias_length)
+#define argus_help_string ARGUS_CONCAT(ARGUS_PREFIX, argus_help_string)
+#define print_help ARGUS_CONCAT(ARGUS_PREFIX, print_help)
+#define argus_spellings ARGUS_CONCAT(ARGUS_PREFIX, argus_spellings)
+#define argus_spelling_count ARGUS_CONCAT(ARGUS_PREFIX, argus_spelling_count)
+#define argus_sorted_spellings ARGUS_CONCAT(ARGUS_PREFIX, argus_sorted_spellings)
+#define argus_sorted_spellings_ready ARGUS_CONCAT(ARGUS_PREFIX, argus_sorted_spellings_ready)
+#define argus_sort_spellings ARGUS_CONCAT(ARGUS_PREFIX, argus_sort_spellings)
+#define complete_args ARGUS_CONCAT(ARGUS_PREFIX, complete_args)
+#define print_completion ARGUS_CONCAT(ARGUS_PREFIX, print_completion)
+#define argus_layout ARGUS_CONCAT(ARGUS_PREFIX, argus_layout)
+#define argus_serialize ARGUS_CONCAT(ARGUS_PREFIX, argus_serialize)
+#define argus_deserialize ARGUS_CONCAT(ARGUS_PREFIX, argus_deserialize)
+#define argus_to_argv ARGUS_CONCAT(ARGUS_PREFIX, argus_to_argv)
+#define argus_diff ARGUS_CONCAT(ARGUS_PREFIX, argus_diff)
+#define argus_env_names ARGUS_CONCAT(ARGUS_PREFIX, argus_env_names)
+#define ARGUS_ENV_SLOTS ARGUS_CONCAT(ARGUS_PREFIX, ARGUS_ENV_SLOTS)
+#define argus_env_slots ARGUS_CONCAT(ARGUS_PREFIX, argus_env_slots)
+#define argus_env_slots_ready ARGUS_CONCAT(ARGUS_PREFIX, argus_env_slots_ready)
+#define parse_env_ex ARGUS_CONCAT(ARGUS_PREFIX, parse_env_ex)
+#define parse_env ARGUS_CONCAT(ARGUS_PREFIX, parse_env)
+#define parse_config_buffer_ex ARGUS_CONCAT(ARGUS_PREFIX, parse_config_buffer_ex)
+#define parse_config_file_ex ARGUS_CONCAT(ARGUS_PREFIX, parse_config_file_ex)
+#define parse_config_buffer ARGUS_CONCAT(ARGUS_PREFIX, parse_config_buffer)
+#define parse_config_file ARGUS_CONCAT(ARGUS_PREFIX, parse_config_file)
+#else
+#define ARGUS_ARGS_H
+#define ARGUS_ID(name) ARGUS_ID_##name
+#define ARGUS_GETTER(name) args_get_##name
+#define ARGUS_SETTER(name) args_set_##name
+#define ARGUS_WRAPPED(name) argus_wrapped_##name
+#endif
+
+// COUNT ARGUMENTS
+#ifdef REQUIRED_ARGS
+#define REQUIRED_ARG(...) +1
+static const int REQUIRED_ARG_COUNT = 0 REQUIRED_ARGS;
+#undef REQUIRED_ARG
+#else
+static const int REQUIRED_ARG_COUNT = 0;
+#endif
+
+#ifdef OPTIONAL_ARGS
+#define OPTIONAL_ARG(...) +1
+static const int OPTIONAL_ARG_COUNT = 0 OPTIONAL_ARGS;
+#undef OPTIONAL_ARG
+#else
+static const int OPTIONAL_ARG_COUNT = 0;
+#endif
+
+#ifdef BOOLEAN_ARGS
+#define BOOLEAN_ARG(...) +1
+static const int BOOLEAN_ARG_COUNT = 0 BOOLEAN_ARGS;
+#undef BOOLEAN_ARG
+#else
+static const int BOOLEAN_ARG_COUNT = 0;
+#endif
+
+#ifdef REPEATED_ARGS
+#define REPEATED_ARG(...) +1
+static const int REPEATED_ARG_COUNT = 0 REPEATED_ARGS;
+#undef REPEATED_ARG
+#else
+static const int REPEATED_ARG_COUNT = 0;
+#endif
+
+// ARG_T STRUCT
+#ifdef ARGUS_PACKED_LAYOUT
+// Stores argument values, ordered by alignment, with the booleans packed into a bitset
+#define REQUIRED_ARG(type, name, label, description, parser) ARGUS_UNSIZED_FIELD(type, name, parser)
+#define OPTIONAL_ARG(type, name, shortopt, longopt, arg_label, default, description, formatter, parser) \
+    ARGUS_UNSIZED_FIELD(type, name, parser)
+typedef struct {
+#ifdef REQUIRED_ARGS
+    REQUIRED_ARGS
+#endif
+#ifdef OPTIONAL_ARGS
+    OPTIONAL_ARGS
+#endif
+#undef REQUIRED_ARG
+#undef OPTIONAL_ARG
+#define REQUIRED_ARG(type, name, label, description, parser) ARGUS_PASS_FIELD(ARGUS_PASS, type, name, parser)
+#define OPTIONAL_ARG(type, name, shortopt, longopt, arg_label, default, description, formatter, parser) \
+    ARGUS_PASS_FIELD(ARGUS_PASS, type, name, parser)
+#define ARGUS_PASS WIDE
+#ifdef REQUIRED_ARGS
+    REQUIRED_ARGS
+#endif
+#ifdef OPTIONAL_ARGS
+    OPTIONAL_ARGS
+#endif
+#undef ARGUS_PASS
+#define ARGUS_PASS WORD
+#ifdef REQUIRED_ARGS
+    REQUIRED_ARGS
+#endif
+#ifdef OPTIONAL_ARGS
+    OPTIONAL_ARGS
+#endif
+#ifdef REPEATED_ARGS
+#define REPEATED_ARG(type, name, ...) \
+    type* name;                       \
+    size_t name##_count;
+    REPEATED_ARGS
+#undef REPEATED_ARG
+    void* argus_storage;  // Block holding the repeated values when parse_args allocated it
+#endif
+#ifdef ARGUS_RESPONSE_FILES
+    argus_loaded_file_t* argus_responses;  // Response files the arguments were parsed from, released by free_args()
+#endif
+#ifdef ARGUS_CONFIG_FILES
+    argus_loaded_file_t* argus_configs;  // Config files loaded into the arguments, released by free_args()
+#endif
+#ifdef BOOLEAN_ARGS
+#define BOOLEAN_ARG(...) +1
+    uint64_t argus_flags[(0 BOOLEAN_ARGS + 63) / 64];  // Bit ARGUS_ID(name) - OPTIONAL_ARG_COUNT holds name
+#undef BOOLEAN_ARG
+#endif
+#if defined(ARGUS_LAZY) && defined(OPTIONAL_ARGS)
+#undef OPTIONAL_ARG
+#define OPTIONAL_ARG(type, name, ...) argus_lazy_t argus_lazy_##name;
+    OPTIONAL_ARGS
+#undef OPTIONAL_ARG
+#define OPTIONAL_ARG(type, name, shortopt, longopt, arg_label, default, description, formatter, parser) \
+    ARGUS_PASS_FIELD(ARGUS_PASS, type, name, parser)
+#endif
+#undef ARGUS_PASS
+#define ARGUS_PASS HALF
+#ifdef REQUIRED_ARGS
+    REQUIRED_ARGS
+#endif
+#ifdef OPTIONAL_ARGS
+    OPTIONAL_ARGS
+#endif
+#undef ARGUS_PASS
+#define ARGUS_PASS BYTE
+#ifdef REQUIRED_ARGS
+    REQUIRED_ARGS
+#endif
+#ifdef OPTIONAL_ARGS
+    OPTIONAL_ARGS
+#endif
+#undef ARGUS_PASS
+} args_t;
+#undef REQUIRED_ARG
+#undef OPTIONAL_ARG
+#else
+#define REQUIRED_ARG(type, name, ...) type name;
+#define OPTIONAL_ARG(type, name, ...) type name;
+#define BOOLEAN_ARG(name, ...) bool name;
+#define REPEATED_ARG(type, name, ...) \
+    type* name;                       \
+    size_t name##_count;
+// Stores argument values
+typedef struct {
+#ifdef REQUIRED_ARGS
+    REQUIRED_ARGS
+#endif
+#ifdef OPTIONAL_ARGS
+    OPTIONAL_ARGS
+#endif
+#ifdef BOOLEAN_ARGS
+    BOOLEAN_ARGS
+#endif
+#ifdef REPEATED_ARGS
+    REPEATED_ARGS
+    void* argus_storage;  // Block holding the repeated values when parse_args allocated it
+#endif
+#ifdef ARGUS_RESPONSE_FILES
+    argus_loaded_file_t* argus_responses;  // Response files the arguments were parsed from, released by free_args()
+#endif
+#ifdef ARGUS_CONFIG_FILES
+    argus_loaded_file_t* argus_configs;  // Config files loaded into the arguments, released by free_args()
+#endif
+#if defined(ARGUS_LAZY) && defined(OPTIONAL_ARGS)
+#undef OPTIONAL_ARG
+#define OPTIONAL_ARG(type, name, ...) argus_lazy_t argus_lazy_##name;
+    OPTIONAL_ARGS
+#endif
+} args_t;
+#undef REQUIRED_ARG
+#undef OPTIONAL_ARG
+#undef BOOLEAN_ARG
+#undef REPEATED_ARG
+#endif
+
+#ifndef ARGUS_DECLARATIONS_ONLY
+// Build an args_t struct with assigned default values
+ARGUS_API args_t make_default_args(void) {
+    args_t args = {
+#define REQUIRED_ARG(type, name, ...) .name = (type)0,
+#define OPTIONAL_ARG(type, name, shortopt, longopt, arg_label, default, ...) .name = default,
+#ifdef ARGUS_PACKED_LAYOUT
+#define BOOLEAN_ARG(...)
+#else
+#define BOOLEAN_ARG(name, ...) .name = 0,
+#endif
+#define REPEATED_ARG(type, name, ...) .name = NULL, .name##_count = 0,
+
+#ifdef REQUIRED_ARGS
+        REQUIRED_ARGS
+#endif
+
+#undef OPTIONAL_LIST_ARG
+#define OPTIONAL_LIST_ARG(...)  // Empty lists are all zeros
+
+#ifdef OPTIONAL_ARGS
+            OPTIONAL_ARGS
+#endif
+
+#undef OPTIONAL_LIST_ARG
+#define OPTIONAL_LIST_ARG ARGUS_LIST_AS_OPTIONAL
+
+#ifdef BOOLEAN_ARGS
+                BOOLEAN_ARGS
+#ifdef ARGUS_PACKED_LAYOUT
+                    .argus_flags = {0},
+#endif
+#endif
+
+#ifdef REPEATED_ARGS
+                    REPEATED_ARGS.argus_storage = NULL,
+#endif
+
+#undef REQUIRED_ARG
+#undef OPTIONAL_ARG
+#undef BOOLEAN_ARG
+#undef REPEATED_ARG
+    };
+
+    return args;
+}
+
+// Release the storage parse_args allocated for repeated arguments and the response and config files loaded into args
+ARGUS_API void free_args(args_t* args) {
+    (void)args;  // Unused without repeated arguments, response and config files
+#ifdef REPEATED_ARGS
+    free(args->argus_storage);
+    args->argus_storage = NULL;
+#endif
+#ifdef ARGUS_RESPONSE_FILES
+    argus_release_files(&args->argus_responses);
+#endif
+#ifdef ARGUS_CONFIG_FILES
+    argus_release_files(&args->argus_configs);
+#endif
+}
+#endif
+
+// OPTION IDS
+// Every optional, boolean and repeated argument gets an index, in declaration order. The required arguments are
+// numbered after them, so every field of args_t has an id.
+#define REQUIRED_ARG(type, name, ...) ARGUS_ID(name),
+#define OPTIONAL_ARG(type, name, ...) ARGUS_ID(name),
+#define BOOLEAN_ARG(name, ...) ARGUS_ID(name),
+#define REPEATED_ARG(type, name, ...) ARGUS_ID(name),
+enum {
+#ifdef OPTIONAL_ARGS
+    OPTIONAL_ARGS
+#endif
+#ifdef BOOLEAN_ARGS
+    BOOLEAN_ARGS
+#endif
+#ifdef REPEATED_ARGS
+    REPEATED_ARGS
+#endif
+    ARGUS_OPTION_COUNT,
+    ARGUS_ID(argus_last_option) = ARGUS_OPTION_COUNT - 1,
+#ifdef REQUIRED_ARGS
+    REQUIRED_ARGS
+#endif
+    ARGUS_FIELD_COUNT
+};
+#undef REQUIRED_ARG
+#undef OPTIONAL_ARG
+#undef BOOLEAN_ARG
+#undef REPEATED_ARG
+
+// The fields argus_diff() found changed, bit ARGUS_ID(name) for every field
+typedef struct {
+    uint64_t bits[ARGUS_FIELD_COUNT / 64 + 1];
+} argus_diff_t;
+
+#ifdef BOOLEAN_ARGS
+// BOOLEAN ACCESSORS
+// args_get_<name>() and args_set_<name>() work with either layout, in ARGUS_PACKED_LAYOUT they are the only way in
+#ifdef ARGUS_PACKED_LAYOUT
+#define BOOLEAN_ARG(name, ...)                                              \
+    static inline bool ARGUS_GETTER(name)(const args_t* args) {             \
+        const int bit = ARGUS_ID(name) - OPTIONAL_ARG_COUNT;                \
+        return (args->argus_flags[bit / 64] >> (bit % 64)) & 1;             \
+    }                                                                       \
+    static inline void ARGUS_SETTER(name)(args_t* args, const bool value) { \
+        const int bit = ARGUS_ID(name) - OPTIONAL_ARG_COUNT;                \
+        args->argus_flags[bit / 64] &= ~((uint64_t)1 << (bit % 64));        \
+        args->argus_flags[bit / 64] |= (uint64_t)value << (bit % 64);       \
+    }
+#else
+#define BOOLEAN_ARG(name, ...)                                                       \
+    static inline bool ARGUS_GETTER(name)(const args_t* args) { return args->name; } \
+    static inline void ARGUS_SETTER(name)(args_t* args, const bool value) { args->name = value; }
+#endif
+BOOLEAN_ARGS
+#undef BOOLEAN_ARG
+#endif
+
+#ifdef ARGUS_BATCH
+#ifdef ARGUS_LAZY
+#error "ARGUS_BATCH can't be combined with ARGUS_LAZY"
+#endif
+// BATCH RESULTS
+// parse_args_batch() stores every argument in an array of its own, indexed by line, so code that scans one argument
+// only touches that array
+#define REQUIRED_ARG(type, name, ...) type* name;
+#define OPTIONAL_ARG(type, name, ...) type* name;
+#define BOOLEAN_ARG(name, ...) bool* name;
+#define REPEATED_ARG(type, name, ...) \
+    type** name;                      \
+    size_t* name##_count;
+typedef struct {
+    size_t         argus_count;   // Number of lines
+    size_t         argus_failed;  // Number of lines that failed to parse, they hold the defaults
+    argus_error_t* argus_errors;  // Error of every line, ARGUS_OK if it parsed
+#ifdef REQUIRED_ARGS
+    REQUIRED_ARGS
+#endif
+#ifdef OPTIONAL_ARGS
+    OPTIONAL_ARGS
+#endif
+#ifdef BOOLEAN_ARGS
+    BOOLEAN_ARGS
+#endif
+#ifdef REPEATED_ARGS
+    REPEATED_ARGS
+    void** argus_storage;  // Block holding the repeated values of every line
+#endif
+    void* argus_block;  // Single allocation holding every array
+} args_batch_t;
+#undef REQUIRED_ARG
+#undef OPTIONAL_ARG
+#undef BOOLEAN_ARG
+#undef REPEATED_ARG
+#endif
+
+#ifdef ARGUS_RELOAD
+#ifdef ARGUS_LAZY
+#error "ARGUS_RELOAD can't be combined with ARGUS_LAZY"
+#endif
+#ifndef ARGUS_HAVE_ATOMICS
+#error "ARGUS_RELOAD needs C11 atomics or the GCC atomic builtins"
+#endif
+// RELOADABLE ARGUMENTS
+// Two args_t take turns: readers use the published one while the other one is parsed. A replaced args_t is only
+// released once every registered reader has announced a quiescent point after it was replaced.
+typedef struct {
+    ARGUS_ATOMIC(args_t*) argus_current;     // The published arguments
+    ARGUS_ATOMIC(uint64_t) argus_epoch;      // Number of publications so far
+    uint64_t               argus_replaced;   // Epoch that replaced the other buffer, 0 once no reader can hold it
+    args_t                 argus_buffers[2];
+    union {
+        ARGUS_ATOMIC(uint64_t) seen;  // Epoch the reader saw at its last quiescent point, or ARGUS_RELOAD_UNUSED
+        char                   argus_line[ARGUS_CACHE_LINE];
+    } argus_readers[ARGUS_RELOAD_MAX_READERS];
+} args_reload_t;
+#endif
+
+#ifdef ARGUS_DECLARATIONS_ONLY
+// DECLARATIONS
+// The file that defined ARGUS_IMPLEMENTATION holds the definitions, documented where they are defined
+ARGUS_API args_t make_default_args(void);
+ARGUS_API void free_args(args_t* args);
+ARGUS_API int parse_args_arena_ex(const int argc, const char* const argv[], args_t* args, void* storage,
+                                  size_t storage_size, argus_error_t* err);
+ARGUS_API int parse_args_ex(const int argc, const char* const argv[], args_t* args, argus_error_t* err);
+ARGUS_API int parse_args_r(const int argc, const char* const argv[], args_t* args, void* storage, size_t storage_size,
+                           argus_error_t* err);
+ARGUS_API int parse_args_arena(const int argc, const char* const argv[], args_t* args, void* storage,
+                               size_t storage_size);
+ARGUS_API int parse_args(const int argc, const char* const argv[], args_t* args);
+ARGUS_API int parse_args_line_ex(char* buf, size_t len, args_t* args, argus_error_t* err);
+ARGUS_API int parse_args_line(char* buf, size_t len, args_t* args);
+#ifdef ARGUS_STATS
+ARGUS_STATS_STORAGE ARGUS_ATOMIC(uint64_t) argus_parse_ns[ARGUS_OPTION_COUNT + 1];
+#endif
+#ifdef ARGUS_BATCH
+ARGUS_API int parse_args_batch(char* const lines[], size_t n, args_batch_t* out, int nthreads);
+ARGUS_API void free_args_batch(args_batch_t* batch);
+#endif
+#ifdef ARGUS_RELOAD
+ARGUS_API void args_reload_init(args_reload_t* reload);
+ARGUS_API args_t* args_reload_begin(args_reload_t* reload);
+ARGUS_API void args_reload_publish(args_reload_t* reload);
+ARGUS_API int args_reload_register(args_reload_t* reload);
+ARGUS_API const args_t* args_reload_read(args_reload_t* reload);
+ARGUS_API void args_reload_quiescent(args_reload_t* reload, int reader);
+ARGUS_API void args_reload_unregister(args_reload_t* reload, int reader);
+ARGUS_API void free_args_reload(args_reload_t* reload);
+#endif
+#if defined(ARGUS_LAZY) && defined(OPTIONAL_ARGS)
+#define OPTIONAL_ARG(type, name, ...)                                                                 \
+    ARGUS_API int ARGUS_CONCAT(ARGUS_GETTER(name), _ex)(args_t* args, type* out, argus_error_t* err); \
+    ARGUS_API type ARGUS_GETTER(name)(args_t* args);
+OPTIONAL_ARGS
+#undef OPTIONAL_ARG
+#endif
+#ifdef ENV_ARGS
+ARGUS_API int parse_env_ex(args_t* args, argus_error_t* err);
+ARGUS_API int parse_env(args_t* args);
+#endif
+#ifdef ARGUS_CONFIG_FILES
+ARGUS_API int parse_config_buffer_ex(char* buf, size_t len, args_t* args, argus_error_t* err);
+ARGUS_API int parse_config_file_ex(const char* path, args_t* args, argus_error_t* err);
+ARGUS_API int parse_config_buffer(char* buf, size_t len, args_t* args);
+ARGUS_API int parse_config_file(const char* path, args_t* args);
+#endif
+ARGUS_API const char* argus_help_string(const char* exec_alias);
+ARGUS_API void print_help(const char* exec_alias);
+ARGUS_API int complete_args(const int argc, const char* const argv[]);
+ARGUS_API int print_completion(const char* shell_name, const char* exec_name);
+ARGUS_API uint64_t argus_layout(void);
+ARGUS_API size_t argus_serialize(const args_t* args, void* buf, size_t size);
+ARGUS_API int argus_deserialize(const void* buf, size_t size, args_t* args, argus_error_t* err);
+ARGUS_API int argus_to_argv(const args_t* args, const char* exec_name, int* argc, char*** argv, argus_error_t* err);
+ARGUS_API argus_diff_t argus_diff(const args_t* a, const args_t* b);
+#else
+// LONG OPTION LOOKUP
+#define ARGUS_LONG_NAME(longopt) {#longopt, sizeof(#longopt) - 1},
+#define ARGUS_NO_NAME(...) {NULL, 0},
+#define OPTIONAL_ARG(type, name, shortopt, longopt, ...) NOT_NONE_ELSE(longopt, ARGUS_LONG_NAME, ARGUS_NO_NAME)(longopt)
+#define BOOLEAN_ARG(name, shortopt, longopt, ...) NOT_NONE_ELSE(longopt, ARGUS_LONG_NAME, ARGUS_NO_NAME)(longopt)
+#define REPEATED_ARG(type, name, shortopt, longopt, ...) NOT_NONE_ELSE(longopt, ARGUS_LONG_NAME, ARGUS_NO_NAME)(longopt)
+// Long option names indexed by option id
+static const argus_name_t argus_long_names[ARGUS_OPTION_COUNT + 1] = {
+#ifdef OPTIONAL_ARGS
+    OPTIONAL_ARGS
+#endif
+#ifdef BOOLEAN_ARGS
+    BOOLEAN_ARGS
+#endif
+#ifdef REPEATED_ARGS
+    REPEATED_ARGS
+#endif
+    {NULL, 0}};
+#undef OPTIONAL_ARG
+#undef BOOLEAN_ARG
+#undef REPEATED_ARG
+#undef ARGUS_LONG_NAME
+#undef ARGUS_NO_NAME
+
+// The hash table is kept at most half full, so every probe sequence is short
+enum { ARGUS_LONG_SLOTS = ARGUS_POW2_CEIL(2 * ARGUS_OPTION_COUNT + 2) };
+
+// Open addressing table storing (option id + 1), 0 marks an empty slot
+static unsigned short argus_long_slots[ARGUS_LONG_SLOTS];
+static argus_once_t argus_long_slots_ready;
+
+// Fill the hash table
+static inline void argus_build_long_slots(void) {
+    argus_fill_slots(argus_long_names, ARGUS_OPTION_COUNT, argus_long_slots, ARGUS_LONG_SLOTS - 1);
+    argus_once_end(&argus_long_slots_ready);
+}
+
+/**
+ * @brief Find an option by its long name
+ *
+ * @param[in] name Long option without the leading "--"
+ *
+ * @retval The id of the option or -1 if there is no such option
+ */
+static inline int argus_find_long(const char* name) {
+    if (argus_once_begin(&argus_long_slots_ready)) argus_build_long_slots();
+
+    size_t len;
+    uint32_t hash = argus_hash(name, &len);
+    return argus_probe_slots(argus_long_names, argus_long_slots, ARGUS_LONG_SLOTS - 1, name, len, hash);
+}
+
+#ifdef ARGUS_ABBREVIATED_LONGOPTS
+// Ids of the options with a long name, sorted by it
+static unsigned short argus_long_order[ARGUS_OPTION_COUNT + 1];
+static size_t argus_long_order_count;
+static argus_once_t argus_long_order_ready;
+
+// Sort the long names
+static inline void argus_build_long_order(void) {
+    argus_long_order_count = argus_sort_names(argus_long_names, ARGUS_OPTION_COUNT, argus_long_order);
+    argus_once_end(&argus_long_order_ready);
+}
+
+/**
+ * @brief Find an option by its long name or by a prefix no other long name starts with
+ *
+ * @param[in] name Long option without the leading "--", it may be followed by "=value"
+ * @param[out] value Set to the text after the '=' or to NULL if there is none
+ *
+ * @retval The id of the option, -1 if there is no such option or ARGUS_AMBIGUOUS_ID if name starts several
+ */
+static inline int argus_find_abbrev(const char* name, const char** value) {
+    if (argus_once_begin(&argus_long_order_ready)) argus_build_long_order();
+    return argus_walk_prefix(argus_long_names, argus_long_order, argus_long_order_count, name, value);
+}
+#endif
+
+// SHORT OPTION LOOKUP
+// Maps every character to (option id + 1), 0 marks a character that is not a short option
+static unsigned short argus_short_ids[256];
+static argus_once_t argus_short_ids_ready;
+
+// Fill the lookup table. If two options share a short flag the first one declared wins, like in the compare chain.
+static inline void argus_build_short_ids(void) {
+#define ARGUS_SHORT_ID(name, shortopt)                                     \
+    if (argus_short_ids[(unsigned char)#shortopt[0]] == 0) {               \
+        argus_short_ids[(unsigned char)#shortopt[0]] = ARGUS_ID(name) + 1; \
+    }
+#define OPTIONAL_ARG(type, name, shortopt, ...) NOT_NONE(shortopt, ARGUS_SHORT_ID)(name, shortopt)
+#define BOOLEAN_ARG(name, shortopt, ...) NOT_NONE(shortopt, ARGUS_SHORT_ID)(name, shortopt)
+#define REPEATED_ARG(type, name, shortopt, ...) NOT_NONE(shortopt, ARGUS_SHORT_ID)(name, shortopt)
+
+#ifdef OPTIONAL_ARGS
+    OPTIONAL_ARGS
+#endif
+#ifdef BOOLEAN_ARGS
+    BOOLEAN_ARGS
+#endif
+#ifdef REPEATED_ARGS
+    REPEATED_ARGS
+#endif
+
+#undef OPTIONAL_ARG
+#undef BOOLEAN_ARG
+#undef REPEATED_ARG
+#undef ARGUS_SHORT_ID
+    argus_once_end(&argus_short_ids_ready);
+}
+
+/**
+ * @brief Find an option by its short flag
+ *
+ * @param[in] flag The flag character
+ *
+ * @retval The id of the option or -1 if there is no such option
+ */
+static inline int argus_find_short(char flag) {
+    if (argus_once_begin(&argus_short_ids_ready)) argus_build_short_ids();
+    return (int)argus_short_ids[(unsigned char)flag] - 1;
+}
+
+#ifdef ARGUS_STATS
+// Time spent parsing the values of every argument, indexed by ARGUS_ID_<name>. Required arguments share the last slot.
+ARGUS_STATS_STORAGE ARGUS_ATOMIC(uint64_t) argus_parse_ns[ARGUS_OPTION_COUNT + 1];
+#endif
+
+#ifdef ARGUS_TABLE_DRIVEN
+#ifdef ARGUS_LAZY
+#error "ARGUS_TABLE_DRIVEN can't be combined with ARGUS_LAZY"
+#endif
+#ifdef ARGUS_ON_OPTION
+// The hook takes the bare name of the option, which the loop only has as a string
+#error "ARGUS_TABLE_DRIVEN can't be combined with ARGUS_ON_OPTION"
+#endif
+// TABLE-DRIVEN BACKEND
+// Arguments are described by a constant table, which a single loop parses argv through
+#define ARGUS_WRAP_PARSER(type, name, parser)                                                    \
+    static inline int ARGUS_WRAPPED(name)(const char* text, void* value, const char** advance) { \
+        type scratch;                                                                            \
+        return parser(text, value != NULL ? (type*)value : &scratch, advance);                   \
+    }
+#define ARGUS_CUSTOM_PARSER(type, name, parser) \
+    EVAL_SELECT_3RD((ARGUS_UNTYPED_##parser, DO_NOTHING, ARGUS_WRAP_PARSER))(type, name, parser)
+#define REQUIRED_ARG(type, name, label, description, parser) ARGUS_CUSTOM_PARSER(type, name, parser)
+#define OPTIONAL_ARG(type, name, shortopt, longopt, arg_label, default, description, formatter, parser) \
+    ARGUS_CUSTOM_PARSER(type, name, parser)
+#define REPEATED_ARG(type, name, shortopt, longopt, arg_label, description, parser) \
+    ARGUS_CUSTOM_PARSER(type, name, parser)
+#ifdef REQUIRED_ARGS
+REQUIRED_ARGS
+#endif
+#ifdef OPTIONAL_ARGS
+OPTIONAL_ARGS
+#endif
+#ifdef REPEATED_ARGS
+REPEATED_ARGS
+#endif
+#undef REQUIRED_ARG
+#undef OPTIONAL_ARG
+#undef REPEATED_ARG
+
+#define ARGUS_SHARED_PARSER(name, parser) argus_untyped_##parser
+#define ARGUS_OWN_PARSER(name, parser) ARGUS_WRAPPED(name)
+#define ARGUS_DESC_PARSER(name, parser) \
+    EVAL_SELECT_3RD((ARGUS_UNTYPED_##parser, ARGUS_SHARED_PARSER, ARGUS_OWN_PARSER))(name, parser)
+#define ARGUS_DESC_LONG(longopt) "--" #longopt
+#define ARGUS_DESC_SHORT(shortopt) "-" #shortopt
+#define ARGUS_DESC_NONE(...) NULL
+#define ARGUS_DESC_SPELLINGS(shortopt, longopt)                        \
+    NOT_NONE_ELSE(longopt, ARGUS_DESC_LONG, ARGUS_DESC_NONE)(longopt), \
+        NOT_NONE_ELSE(shortopt, ARGUS_DESC_SHORT, ARGUS_DESC_NONE)(shortopt)
+#ifdef ARGUS_PACKED_LAYOUT
+#define ARGUS_FLAG_OFFSET(name) offsetof(args_t, argus_flags)
+#else
+#define ARGUS_FLAG_OFFSET(name) offsetof(args_t, name)
+#endif
+#define REQUIRED_ARG(type, name, label, description, parser)                                                 \
+    {#name, NULL, NULL, #type, label, NULL, description, ARGUS_KIND_REQUIRED, -1, offsetof(args_t, name), 0, \
+     sizeof(type), ARGUS_DESC_PARSER(name, parser)},
+#define OPTIONAL_ARG(type, name, shortopt, longopt, arg_label, default, description, formatter, parser) \
+    {#name,                                                                                             \
+     ARGUS_DESC_SPELLINGS(shortopt, longopt),                                                           \
+     #type,                                                                                             \
+     arg_label,                                                                                         \
+     #default,                                                                                          \
+     description,                                                                                       \
+     ARGUS_KIND_OPTIONAL,                                                                               \
+     ARGUS_ID(name),                                                                                    \
+     offsetof(args_t, name),                                                                            \
+     0,                                                                                                 \
+     sizeof(type),                                                                                      \
+     ARGUS_DESC_PARSER(name, parser)},
+#define BOOLEAN_ARG(name, shortopt, longopt, description)                                                    \
+    {#name, ARGUS_DESC_SPELLINGS(shortopt, longopt), "bool", NULL, "false", description, ARGUS_KIND_BOOLEAN, \
+     ARGUS_ID(name), ARGUS_FLAG_OFFSET(name), 0, sizeof(bool), NULL},
+#define REPEATED_ARG(type, name, shortopt, longopt, arg_label, description, parser) \
+    {#name,                                                                         \
+     ARGUS_DESC_SPELLINGS(shortopt, longopt),                                       \
+     #type,                                                                         \
+     arg_label,                                                                     \
+     NULL,                                                                          \
+     description,                                                                   \
+     ARGUS_KIND_REPEATED,                                                           \
+     ARGUS_ID(name),                                                                \
+     offsetof(args_t, name),                                                        \
+     offsetof(args_t, name##_count),                                                \
+     sizeof(type),                                                                  \
+     ARGUS_DESC_PARSER(name, parser)},
+
+// Options indexed by option id, followed by the required arguments in order. Programs can also walk it to inspect
+// their own arguments.
+static const argus_opt_desc_t argus_descriptors[] = {
+#ifdef OPTIONAL_ARGS
+    OPTIONAL_ARGS
+#endif
+#ifdef BOOLEAN_ARGS
+    BOOLEAN_ARGS
+#endif
+#ifdef REPEATED_ARGS
+    REPEATED_ARGS
+#endif
+#ifdef REQUIRED_ARGS
+    REQUIRED_ARGS
+#endif
+    {NULL, NULL, NULL, NULL, NULL, NULL, NULL, ARGUS_KIND_REQUIRED, -1, 0, 0, 0, NULL}};
+#undef REQUIRED_ARG
+#undef OPTIONAL_ARG
+#undef BOOLEAN_ARG
+#undef REPEATED_ARG
+
+// Number of descriptors, the last entry only keeps the array from being empty
+static const size_t argus_descriptor_count = sizeof(argus_descriptors) / sizeof(argus_descriptors[0]) - 1;
+
+// Id of the option spelled arg, which starts with "--", or -1. The first option declared wins, like in the compare
+// chain. With ARGUS_ABBREVIATED_LONGOPTS arg may be a prefix of the option followed by "=value", whose value is
+// stored in attached.
+static inline int argus_table_find_long(const char* arg, const char** attached) {
+#ifdef ARGUS_ABBREVIATED_LONGOPTS
+    return argus_find_abbrev(arg + 2, attached);
+#elif defined(ARGUS_HASHED_LONGOPTS)
+    (void)attached;
+    return argus_find_long(arg + 2);
+#else
+    (void)attached;
+    for (int id = 0; id < ARGUS_OPTION_COUNT; id++) {
+        const char* longopt = argus_descriptors[id].longopt;
+        if (longopt != NULL && ARGUS_COMPARE(strcmp(arg, longopt) == 0)) return id;
+    }
+    return -1;
+#endif
+}
+
+// Id of the option with the short flag, or -1
+static inline int argus_table_find_short(const char flag) {
+#ifdef ARGUS_INDEXED_SHORTOPTS
+    return argus_find_short(flag);
+#else
+    for (int id = 0; id < ARGUS_OPTION_COUNT; id++) {
+        const char* shortopt = argus_descriptors[id].shortopt;
+        if (shortopt != NULL && ARGUS_COMPARE(shortopt[1] == flag)) return id;
+    }
+    return -1;
+#endif
+}
+
+// Parse text into the argument with the given id. Repeated values are parsed into a scratch value while counting and
+// into their array slot while filling.
+static inline int argus_table_store(args_t* args, const int id, const char* text, const char** advance,
+                                    const bool fill) {
+    const argus_opt_desc_t* desc  = &argus_descriptors[id];
+    char* const             field = (char*)args + desc->offset;
+    if (desc->kind != ARGUS_KIND_REPEATED) return desc->parser(text, field, advance);
+
+    size_t* count = (size_t*)((char*)args + desc->count_offset);
+    char*   value = NULL;
+    if (fill) {
+        char* array;
+        memcpy(&array, field, sizeof(array));
+        value = array + *count * desc->size;
+    }
+    (*count)++;
+    return desc->parser(text, value, advance);
+}
+
+// Set the boolean with the given id
+static inline void argus_table_set_flag(args_t* args, const int id) {
+#ifdef ARGUS_PACKED_LAYOUT
+    const int bit = id - OPTIONAL_ARG_COUNT;
+    args->argus_flags[bit / 64] |= (uint64_t)1 << (bit % 64);
+#else
+    *(bool*)((char*)args + argus_descriptors[id].offset) = true;
+#endif
+}
+
+// Hand a positional argument to the sink if there is one, else to the first repeated argument without flags
+static inline int argus_table_positional(const char* const argv[], const int i, args_t* args, const bool fill,
+                                         argus_error_t* err) {
+#ifdef POSITIONAL_SINK
+#define POSITIONAL_SINK_ARG(function, label, description)                                                   \
+    int error = fill ? 0 : function(argv[i], i);                                                            \
+    if (error != 0) {                                                                                       \
+        ARGUS_FAIL(.code = argus_value_error(error), .index = i, .argument = argv[i], .value_type = label); \
+    }                                                                                                       \
+    return 0;
+    (void)args;
+    POSITIONAL_SINK
+#undef POSITIONAL_SINK_ARG
+#else
+    for (int id = 0; id < ARGUS_OPTION_COUNT; id++) {
+        const argus_opt_desc_t* desc = &argus_descriptors[id];
+        if (desc->kind != ARGUS_KIND_REPEATED || desc->longopt != NULL || desc->shortopt != NULL) continue;
+
+        const char* next_char = NULL;
+        ARGUS_PARSE(error, id, argus_table_store(args, id, argv[i], &next_char, fill))
+        if (error != 0) {
+            ARGUS_FAIL(.code = argus_value_error(error), .index = i, .argument = argv[i], .value_type = desc->type);
+        }
+        if (next_char != NULL && *next_char != '\0') {
+            ARGUS_FAIL(.code = ARGUS_ERROR_TRAILING_CHARACTERS, .index = i, .argument = argv[i],
+                       .offset = (size_t)(next_char - argv[i]), .value_type = desc->type);
+        }
+        return 0;
+    }
+    (void)args;
+    (void)fill;
+    ARGUS_FAIL(.code = ARGUS_ERROR_INVALID_ARGUMENT, .index = i, .argument = argv[i]);
+#endif
+}
+
+// Parse an argument vector in which every response file has already been expanded. Unless fill is set, repeated
+// arguments are only counted and args->name must not be touched.
+static inline int argus_scan(const int argc, const char* const argv[], args_t* args, const bool fill,
+                             argus_error_t* err) {
+    if (!argc || !argv) ARGUS_FAIL(.code = ARGUS_ERROR_NULL_ARGV, .index = -1);
+
+    // If not enough required arguments
+    if (argc < 1 + REQUIRED_ARG_COUNT) ARGUS_FAIL(.code = ARGUS_ERROR_MISSING_REQUIRED, .index = argc);
+
+    // Get required arguments
+    for (int i = 1; i <= REQUIRED_ARG_COUNT; i++) {
+        const int id = ARGUS_OPTION_COUNT + i - 1;
+        ARGUS_PARSE(error, ARGUS_OPTION_COUNT, argus_table_store(args, id, argv[i], NULL, fill))
+        if (error != 0) {
+            ARGUS_FAIL(.code = argus_value_error(error), .index = i, .argument = argv[i],
+                       .value_type = argus_descriptors[id].type);
+        }
+    }
+
+    // Get optional and boolean arguments, "--" ends them and everything after it is positional
+    int options_end = argc;
+    for (int i = 1 + REQUIRED_ARG_COUNT; i < options_end; i++) {
+        ARGUS_COUNT(tokens);
+        const char* arg = argv[i];
+        if (arg[0] == '-' && arg[1] == '-' && arg[2] == '\0') {
+            options_end = i;
+            break;
+        }
+
+        const char* attached = NULL;
+        const int   long_id  = arg[0] == '-' && arg[1] == '-' ? argus_table_find_long(arg, &attached) : -1;
+        if (long_id == ARGUS_AMBIGUOUS_ID) {
+            ARGUS_FAIL(.code = ARGUS_ERROR_AMBIGUOUS_OPTION, .index = i, .argument = arg);
+        }
+        if (long_id >= 0) {
+            const argus_opt_desc_t* desc = &argus_descriptors[long_id];
+            if (desc->kind == ARGUS_KIND_BOOLEAN) {
+                if (attached != NULL) {
+                    ARGUS_FAIL(.code = ARGUS_ERROR_UNEXPECTED_VALUE, .index = i, .argument = arg,
+                               .offset = (size_t)(attached - arg), .option = desc->longopt);
+                }
+                argus_table_set_flag(args, long_id);
+                continue;
+            }
+            if (attached == NULL && i + 1 >= argc) {
+                ARGUS_FAIL(.code = ARGUS_ERROR_MISSING_VALUE, .index = i, .option = desc->longopt);
+            }
+            // The value follows the '=' or is the next argument
+            const char* value     = attached != NULL ? attached : argv[++i];
+            const char* next_char = NULL;
+            ARGUS_PARSE(error, long_id, argus_table_store(args, long_id, value, &next_char, fill))
+            if (error != 0) {
+                ARGUS_FAIL(.code = argus_value_error(error), .index = i, .argument = argv[i],
+                           .offset = (size_t)(value - argv[i]), .option = desc->longopt, .value_type = desc->type);
+            }
+            // We don't allow parsing only part of an option
+            if (next_char != NULL && *next_char != '\0') {
+                ARGUS_FAIL(.code = ARGUS_ERROR_TRAILING_CHARACTERS, .index = i, .argument = argv[i],
+                           .offset = (size_t)(next_char - argv[i]), .option = desc->longopt, .value_type = desc->type);
+            }
+            continue;
+        }
+
+        // Parse flags, a value takes whatever its parser leaves of the argument
+        if (arg[0] == '-') {
+            const char* curr_flag = arg + 1;
+            while (curr_flag != NULL && *curr_flag != '\0') {
+                const int id = argus_table_find_short(*curr_flag);
+                if (id < 0) {
+                    ARGUS_FAIL(.code = ARGUS_ERROR_INVALID_FLAG, .index = i, .argument = arg,
+                               .offset = (size_t)(curr_flag - arg));
+                }
+                const argus_opt_desc_t* desc = &argus_descriptors[id];
+                if (desc->kind == ARGUS_KIND_BOOLEAN) {
+                    argus_table_set_flag(args, id);
+                    curr_flag++;
+                    continue;
+                }
+                if (curr_flag[1] == '\0') {
+                    ARGUS_FAIL(.code = ARGUS_ERROR_MISSING_VALUE, .index = i, .argument = arg,
+                               .offset = (size_t)(curr_flag - arg), .option = desc->shortopt);
+                }
+                const char* value = curr_flag + 1;
+                ARGUS_PARSE(error, id, argus_table_store(args, id, value, &curr_flag, fill))
+                if (error != 0) {
+                    ARGUS_FAIL(.code = argus_value_error(error), .index = i, .argument = arg,
+                               .offset = (size_t)(value - arg), .option = desc->shortopt, .value_type = desc->type);
+                }
+            }
+            continue;
+        }
+
+        if (argus_table_positional(argv, i, args, fill, err) != 0) return 1;
+    }
+
+    for (int i = options_end + 1; i < argc; i++) {
+        ARGUS_COUNT(tokens);
+        if (argus_table_positional(argv, i, args, fill, err) != 0) return 1;
+    }
+    return 0;
+}
+#else
+// Parse an argument vector in which every response file has already been expanded. Unless fill is set, repeated
+// arguments are only counted and args->name must not be touched.
+static inline int argus_scan(const int argc, const char* const argv[], args_t* args, const bool fill,
+                             argus_error_t* err) {
+    (void)fill;  // suppress unused parameter warning
+    if (!argc || !argv) ARGUS_FAIL(.code = ARGUS_ERROR_NULL_ARGV, .index = -1);
+
+    // If not enough required arguments
+    if (argc < 1 + REQUIRED_ARG_COUNT) ARGUS_FAIL(.code = ARGUS_ERROR_MISSING_REQUIRED, .index = argc);
+
+// Get required arguments
+#ifdef REQUIRED_ARGS
+#define REQUIRED_ARG(type, name, label, description, parser)                                                    \
+    do {                                                                                                        \
+        ARGUS_PARSE(error, ARGUS_OPTION_COUNT, parser(argv[i], &args->name, NULL))                              \
+        if (error != 0) {                                                                                       \
+            ARGUS_FAIL(.code = argus_value_error(error), .index = i, .argument = argv[i], .value_type = #type); \
+        }                                                                                                       \
+        i++;                                                                                                    \
+    } while (0);
+    int i = 1;
+    REQUIRED_ARGS
+#undef REQUIRED_ARG
+#endif
+
+// Report every matched option once, the first scan sees every option
+#ifdef ARGUS_ON_OPTION
+#define ARGUS_REPORT_OPTION(name) \
+    if (!fill) ARGUS_ON_OPTION(name, i);
+#else
+#define ARGUS_REPORT_OPTION(name)
+#endif
+
+    // Get optional and boolean arguments, "--" ends them and everything after it is positional
+    int options_end = argc;
+    for (int i = 1 + REQUIRED_ARG_COUNT; i < options_end; i++) {
+        ARGUS_COUNT(tokens);
+        if (argv[i][0] == '-' && argv[i][1] == '-' && argv[i][2] == '\0') {
+            options_end = i;
+            break;
+        }
+#ifdef ARGUS_ABBREVIATED_LONGOPTS
+// The value of a long option follows its '=' or is the next argument
+#define ARGUS_HAS_LONG_VALUE(i) (attached != NULL || i + 1 < argc)
+#define ARGUS_LONG_VALUE(i) (attached != NULL ? attached : argv[++i])
+#define ARGUS_REJECT_LONG_VALUE(longopt)                                                  \
+    if (attached != NULL) {                                                               \
+        ARGUS_FAIL(.code = ARGUS_ERROR_UNEXPECTED_VALUE, .index = i, .argument = argv[i], \
+                   .offset = (size_t)(attached - argv[i]), .option = "--" #longopt);      \
+    }
+#else
+#define ARGUS_HAS_LONG_VALUE(i) (i + 1 < argc)
+#define ARGUS_LONG_VALUE(i) argv[++i]
+#define ARGUS_REJECT_LONG_VALUE(longopt)
+#endif
+
+#define LONG_OPT_BODY(type, name, target, longopt, parser)                                                     \
+    {                                                                                                          \
+        if (!ARGUS_HAS_LONG_VALUE(i)) {                                                                        \
+            ARGUS_FAIL(.code = ARGUS_ERROR_MISSING_VALUE, .index = i, .option = "--" #longopt);                \
+        }                                                                                                      \
+        const char* value     = ARGUS_LONG_VALUE(i);                                                           \
+        const char* next_char = NULL;                                                                          \
+        ARGUS_PARSE(error, ARGUS_ID(name), parser(value, target, &next_char))                                  \
+        if (error != 0) {                                                                                      \
+            ARGUS_FAIL(.code = argus_value_error(error), .index = i, .argument = argv[i],                      \
+                       .offset = (size_t)(value - argv[i]), .option = "--" #longopt, .value_type = #type);     \
+        }                                                                                                      \
+        /* We don't allow parsing only part of an option */                                                    \
+        if (next_char != NULL && *next_char != '\0') {                                                         \
+            ARGUS_FAIL(.code = ARGUS_ERROR_TRAILING_CHARACTERS, .index = i, .argument = argv[i],               \
+                       .offset = (size_t)(next_char - argv[i]), .option = "--" #longopt, .value_type = #type); \
+        }                                                                                                      \
+        continue;                                                                                              \
+    }
+
+// In ARGUS_LAZY mode optional values are only located, args_get_<name>() parses them
+#define LONG_LAZY_BODY(name, longopt)                                                           \
+    {                                                                                           \
+        ARGUS_REPORT_OPTION(name)                                                               \
+        if (!ARGUS_HAS_LONG_VALUE(i)) {                                                         \
+            ARGUS_FAIL(.code = ARGUS_ERROR_MISSING_VALUE, .index = i, .option = "--" #longopt); \
+        }                                                                                       \
+        const char* value       = ARGUS_LONG_VALUE(i);                                          \
+        args->argus_lazy_##name = (argus_lazy_t){argv[i], value, "--" #longopt, i};             \
+        continue;                                                                               \
+    }
+
+#ifdef ARGUS_LAZY
+#define LONG_OPTIONAL_BODY(type, name, longopt, parser) LONG_LAZY_BODY(name, longopt)
+#else
+#define LONG_OPTIONAL_BODY(type, name, longopt, parser)         \
+    {                                                           \
+        ARGUS_REPORT_OPTION(name)                               \
+        LONG_OPT_BODY(type, name, &args->name, longopt, parser) \
+    }
+#endif
+
+#define LONG_BOOL_BODY(name, longopt)    \
+    {                                    \
+        ARGUS_REPORT_OPTION(name)        \
+        ARGUS_REJECT_LONG_VALUE(longopt) \
+        ARGUS_SETTER(name)(args, true);  \
+        continue;                        \
+    }
+
+// Repeated values are parsed into a scratch value while counting and into their array slot while filling
+#define REPEATED_TARGET(type, name)                                   \
+    ARGUS_REPORT_OPTION(name)                                         \
+    type scratch;                                                     \
+    type* target = fill ? &args->name[args->name##_count] : &scratch; \
+    args->name##_count++;
+
+#define LONG_REPEATED_BODY(type, name, longopt, parser)    \
+    {                                                      \
+        REPEATED_TARGET(type, name)                        \
+        LONG_OPT_BODY(type, name, target, longopt, parser) \
+    }
+
+#if defined(ARGUS_HASHED_LONGOPTS) || defined(ARGUS_ABBREVIATED_LONGOPTS)
+// One lookup per token, then a jump to the matching option
+#define GENERATE_LONG_OPT(type, name, longopt, parser) \
+    case ARGUS_ID(name):                               \
+        LONG_OPTIONAL_BODY(type, name, longopt, parser)
+#define GENERATE_LONG_BOOL(name, longopt) \
+    case ARGUS_ID(name):                  \
+        LONG_BOOL_BODY(name, longopt)
+#define GENERATE_LONG_REPEATED(type, name, longopt, parser) \
+    case ARGUS_ID(name):                                    \
+        LONG_REPEATED_BODY(type, name, longopt, parser)
+#else
+#define GENERATE_LONG_OPT(type, name, longopt, parser) \
+    if (ARGUS_COMPARE(!strcmp(argv[i], "--" #longopt))) LONG_OPTIONAL_BODY(type, name, longopt, parser)
+#define GENERATE_LONG_BOOL(name, longopt) \
+    if (ARGUS_COMPARE(!strcmp(argv[i], "--" #longopt))) LONG_BOOL_BODY(name, longopt)
+#define GENERATE_LONG_REPEATED(type, name, longopt, parser) \
+    if (ARGUS_COMPARE(!strcmp(argv[i], "--" #longopt))) LONG_REPEATED_BODY(type, name, longopt, parser)
+#endif
+
+// This generates the long opt parsing for an optional argument if it's not NONE
+#define OPTIONAL_ARG(type, name, shortopt, longopt, arg_label, default, description, formatter, parser) \
+    NOT_NONE(longopt, GENERATE_LONG_OPT)(type, name, longopt, parser)
+
+#define BOOLEAN_ARG(name, shortopt, longopt, description) NOT_NONE(longopt, GENERATE_LONG_BOOL)(name, longopt)
+
+#define REPEATED_ARG(type, name, shortopt, longopt, arg_label, description, parser) \
+    NOT_NONE(longopt, GENERATE_LONG_REPEATED)(type, name, longopt, parser)
+
+#ifdef ARGUS_ABBREVIATED_LONGOPTS
+        const char* attached = NULL;
+        if (argv[i][0] == '-' && argv[i][1] == '-') {
+            const int long_id = argus_find_abbrev(argv[i] + 2, &attached);
+            if (long_id == ARGUS_AMBIGUOUS_ID) {
+                ARGUS_FAIL(.code = ARGUS_ERROR_AMBIGUOUS_OPTION, .index = i, .argument = argv[i]);
+            }
+            switch (long_id) {
+#elif defined(ARGUS_HASHED_LONGOPTS)
+        if (argv[i][0] == '-' && argv[i][1] == '-') {
+            switch (argus_find_long(argv[i] + 2)) {
+#endif
+
+#ifdef OPTIONAL_ARGS
+                OPTIONAL_ARGS
+#endif
+
+#ifdef BOOLEAN_ARGS
+                BOOLEAN_ARGS
+#endif
+
+#ifdef REPEATED_ARGS
+                REPEATED_ARGS
+#endif
+
+#if defined(ARGUS_HASHED_LONGOPTS) || defined(ARGUS_ABBREVIATED_LONGOPTS)
+                default:
+                    break;  // Unknown long options are reported by the flag parser below
+            }
+        }
+#endif
+
+#undef OPTIONAL_ARG
+#undef BOOLEAN_ARG
+#undef REPEATED_ARG
+
+        // Parse flags
+        if (argv[i][0] == '-') {
+            const char* curr_flag = argv[i] + 1;
+#define SHORT_OPT_BODY(type, name, target, shortopt, parser)                                               \
+    {                                                                                                      \
+        if (curr_flag[1] == '\0') {                                                                        \
+            ARGUS_FAIL(.code = ARGUS_ERROR_MISSING_VALUE, .index = i, .argument = argv[i],                 \
+                       .offset = (size_t)(curr_flag - argv[i]), .option = "-" #shortopt);                  \
+        }                                                                                                  \
+        const char* value = curr_flag + 1;                                                                 \
+        ARGUS_PARSE(error, ARGUS_ID(name), parser(value, target, &curr_flag))                              \
+        if (error != 0) {                                                                                  \
+            ARGUS_FAIL(.code = argus_value_error(error), .index = i, .argument = argv[i],                  \
+                       .offset = (size_t)(value - argv[i]), .option = "-" #shortopt, .value_type = #type); \
+        }                                                                                                  \
+        /* We set the flag to NULL when we read all of the remaning string  */                             \
+        /* We treat any left string as the next flag */                                                    \
+        continue;                                                                                          \
+    }
+
+// The value of a short option can only end where its parser stops, so in ARGUS_LAZY mode it takes the rest of the
+// argument
+#define SHORT_LAZY_BODY(name, shortopt)                                                     \
+    {                                                                                       \
+        ARGUS_REPORT_OPTION(name)                                                           \
+        if (curr_flag[1] == '\0') {                                                         \
+            ARGUS_FAIL(.code = ARGUS_ERROR_MISSING_VALUE, .index = i, .argument = argv[i],  \
+                       .offset = (size_t)(curr_flag - argv[i]), .option = "-" #shortopt);   \
+        }                                                                                   \
+        args->argus_lazy_##name = (argus_lazy_t){argv[i], curr_flag + 1, "-" #shortopt, i}; \
+        curr_flag               = NULL;                                                     \
+        continue;                                                                           \
+    }
+
+#ifdef ARGUS_LAZY
+#define SHORT_OPTIONAL_BODY(type, name, shortopt, parser) SHORT_LAZY_BODY(name, shortopt)
+#else
+#define SHORT_OPTIONAL_BODY(type, name, shortopt, parser)         \
+    {                                                             \
+        ARGUS_REPORT_OPTION(name)                                 \
+        SHORT_OPT_BODY(type, name, &args->name, shortopt, parser) \
+    }
+#endif
+
+#define SHORT_BOOL_BODY(name)           \
+    {                                   \
+        ARGUS_REPORT_OPTION(name)       \
+        ARGUS_SETTER(name)(args, true); \
+        curr_flag++;                    \
+        continue;                       \
+    }
+
+#define SHORT_REPEATED_BODY(type, name, shortopt, parser)    \
+    {                                                        \
+        REPEATED_TARGET(type, name)                          \
+        SHORT_OPT_BODY(type, name, target, shortopt, parser) \
+    }
+
+#ifdef ARGUS_INDEXED_SHORTOPTS
+// One table lookup per flag character, then a jump to the matching option
+#define GENERATE_SHORT_OPT(type, name, shortopt, parser) \
+    case ARGUS_ID(name):                                 \
+        SHORT_OPTIONAL_BODY(type, name, shortopt, parser)
+#define GENERATE_SHORT_BOOL(name, shortopt) \
+    case ARGUS_ID(name):                    \
+        SHORT_BOOL_BODY(name)
+#define GENERATE_SHORT_REPEATED(type, name, shortopt, parser) \
+    case ARGUS_ID(name):                                      \
+        SHORT_REPEATED_BODY(type, name, shortopt, parser)
+#else
+#define GENERATE_SHORT_OPT(type, name, shortopt, parser) \
+    if (ARGUS_COMPARE(*curr_flag == #shortopt[0])) SHORT_OPTIONAL_BODY(type, name, shortopt, parser)
+#define GENERATE_SHORT_BOOL(name, shortopt) \
+    if (ARGUS_COMPARE(*curr_flag == #shortopt[0])) SHORT_BOOL_BODY(name)
+#define GENERATE_SHORT_REPEATED(type, name, shortopt, parser) \
+    if (ARGUS_COMPARE(*curr_flag == #shortopt[0])) SHORT_REPEATED_BODY(type, name, shortopt, parser)
+#endif
+
+#define OPTIONAL_ARG(type, name, shortopt, longopt, arg_label, default, description, formatter, parser) \
+    NOT_NONE(shortopt, GENERATE_SHORT_OPT)(type, name, shortopt, parser)
+
+#define BOOLEAN_ARG(name, shortopt, longopt, description) NOT_NONE(shortopt, GENERATE_SHORT_BOOL)(name, shortopt)
+
+#define REPEATED_ARG(type, name, shortopt, longopt, arg_label, description, parser) \
+    NOT_NONE(shortopt, GENERATE_SHORT_REPEATED)(type, name, shortopt, parser)
+
+            while (curr_flag != NULL && *curr_flag != '\0') {
+#ifdef ARGUS_INDEXED_SHORTOPTS
+                switch (argus_find_short(*curr_flag)) {
+#endif
+
+#ifdef OPTIONAL_ARGS
+                    OPTIONAL_ARGS
+#endif
+
+#ifdef BOOLEAN_ARGS
+                    BOOLEAN_ARGS
+#endif
+
+#ifdef REPEATED_ARGS
+                    REPEATED_ARGS
+#endif
+
+#ifdef ARGUS_INDEXED_SHORTOPTS
+                    default:
+                        break;
+                }
+#endif
+
+                ARGUS_FAIL(.code = ARGUS_ERROR_INVALID_FLAG, .index = i, .argument = argv[i],
+                           .offset = (size_t)(curr_flag - argv[i]));
+            }
+#undef OPTIONAL_ARG
+#undef BOOLEAN_ARG
+#undef REPEATED_ARG
+
+            continue;
+        }
+
+// Positional arguments go to the sink if there is one, else to the first repeated argument without flags
+#define GENERATE_POSITIONAL(type, name, parser)                                                                 \
+    {                                                                                                           \
+        REPEATED_TARGET(type, name)                                                                             \
+        const char* next_char = NULL;                                                                           \
+        ARGUS_PARSE(error, ARGUS_ID(name), parser(argv[i], target, &next_char))                                 \
+        if (error != 0) {                                                                                       \
+            ARGUS_FAIL(.code = argus_value_error(error), .index = i, .argument = argv[i], .value_type = #type); \
+        }                                                                                                       \
+        if (next_char != NULL && *next_char != '\0') {                                                          \
+            ARGUS_FAIL(.code = ARGUS_ERROR_TRAILING_CHARACTERS, .index = i, .argument = argv[i],                \
+                       .offset = (size_t)(next_char - argv[i]), .value_type = #type);                           \
+        }                                                                                                       \
+        continue;                                                                                               \
+    }
+
+#define REPEATED_ARG(type, name, shortopt, longopt, arg_label, description, parser) \
+    BOTH_NONE(shortopt, longopt, GENERATE_POSITIONAL)(type, name, parser)
+
+// The sink sees every positional once, when the first scan reaches it
+#define POSITIONAL_SINK_ARG(function, label, description)                                                       \
+    {                                                                                                           \
+        int error = fill ? 0 : function(argv[i], i);                                                            \
+        if (error != 0) {                                                                                       \
+            ARGUS_FAIL(.code = argus_value_error(error), .index = i, .argument = argv[i], .value_type = label); \
+        }                                                                                                       \
+        continue;                                                                                               \
+    }
+
+#ifdef POSITIONAL_SINK
+#define ARGUS_POSITIONALS POSITIONAL_SINK
+#elif defined(REPEATED_ARGS)
+#define ARGUS_POSITIONALS REPEATED_ARGS
+#else
+#define ARGUS_POSITIONALS
+#endif
+
+        ARGUS_POSITIONALS
+        ARGUS_FAIL(.code = ARGUS_ERROR_INVALID_ARGUMENT, .index = i, .argument = argv[i]);
+    }
+
+    for (int i = options_end + 1; i < argc; i++) {
+        ARGUS_COUNT(tokens);
+        ARGUS_POSITIONALS
+        ARGUS_FAIL(.code = ARGUS_ERROR_INVALID_ARGUMENT, .index = i, .argument = argv[i]);
+    }
+#undef REPEATED_ARG
+#undef POSITIONAL_SINK_ARG
+#undef ARGUS_POSITIONALS
+
+    return 0;
+}
+#endif
+
+// Parse an expanded argument vector, placing repeated values in storage or in a single allocation if it's NULL
+static inline int argus_parse_argv(const int argc, const char* const argv[], args_t* args, void* storage,
+                                   size_t storage_size, argus_error_t* err) {
+#ifndef REPEATED_ARGS
+    (void)storage;
+    (void)storage_size;
+    return argus_scan(argc, argv, args, false, err);
+#else
+    // First pass: count the values of every repeated argument
+#define REPEATED_ARG(type, name, ...) args->name##_count = 0;
+    REPEATED_ARGS
+    if (argus_scan(argc, argv, args, false, err) != 0) {
+        REPEATED_ARGS  // The arrays were never filled
+        return 1;
+    }
+#undef REPEATED_ARG
+
+    // Lay the arrays out back to back. Offsets into a block that is yet to be allocated are measured from zero, as
+    // malloc returns memory aligned for every type.
+    const uintptr_t origin = (uintptr_t)storage;
+    size_t needed = 0;
+#define REPEATED_ARG(type, name, ...)                       \
+    needed += argus_padding(origin + needed, sizeof(type)); \
+    needed += args->name##_count * sizeof(type);
+    REPEATED_ARGS
+#undef REPEATED_ARG
+    if (needed == 0) return 0;
+
+    char* base = storage == NULL ? (char*)malloc(needed) : (char*)storage;
+    if (base == NULL || (storage != NULL && needed > storage_size)) {
+#define REPEATED_ARG(type, name, ...) args->name##_count = 0;
+        REPEATED_ARGS
+#undef REPEATED_ARG
+        ARGUS_FAIL(.code = base == NULL ? ARGUS_ERROR_NO_MEMORY : ARGUS_ERROR_NO_STORAGE, .index = -1);
+    }
+    if (storage == NULL) {
+        free(args->argus_storage);
+        args->argus_storage = base;
+    }
+
+    // Second pass: fill the arrays
+    size_t offset = 0;
+#define REPEATED_ARG(type, name, ...)                                    \
+    offset += argus_padding(origin + offset, sizeof(type));              \
+    args->name = args->name##_count > 0 ? (type*)(base + offset) : NULL; \
+    offset += args->name##_count * sizeof(type);                         \
+    args->name##_count = 0;
+    REPEATED_ARGS
+#undef REPEATED_ARG
+    return argus_scan(argc, argv, args, true, err);
+#endif
+}
+
+#ifdef ARGUS_RESPONSE_FILES
+// Whether arg is a long option whose value is the next argument
+static inline bool argus_takes_next_value(const char* arg) {
+    if (arg[0] != '-' || arg[1] != '-') return false;
+#ifdef ARGUS_ABBREVIATED_LONGOPTS
+    const char* attached = NULL;
+    const int   id       = argus_find_abbrev(arg + 2, &attached);
+    if (attached != NULL) return false;
+#else
+    const int id = argus_find_long(arg + 2);
+#endif
+    return id >= 0 && (id < OPTIONAL_ARG_COUNT || id >= OPTIONAL_ARG_COUNT + BOOLEAN_ARG_COUNT);
+}
+
+// Follow the scan through the expanded arguments, counted from 1 by position: after the required arguments a "--"
+// ends the options, unless it's the value of the long option before it
+static inline void argus_follow_scan(const char* arg, size_t position, bool* value_next, bool* options_ended) {
+    if (position <= (size_t)REQUIRED_ARG_COUNT || *options_ended) return;
+    if (*value_next) {
+        *value_next = false;
+    } else if (strcmp(arg, "--") == 0) {
+        *options_ended = true;
+    } else {
+        *value_next = argus_takes_next_value(arg);
+    }
+}
+
+// Replace every @file argument with the tokens of that file and parse the result
+static inline int argus_parse_response_files(const int argc, const char* const argv[], args_t* args, void* storage,
+                                             size_t storage_size, argus_error_t* err) {
+    typedef struct {
+        argus_loaded_file_t* loaded;  // The file, linked into args once parsing started
+        size_t count;
+        bool expanded;  // The argument names a response file, rather than being passed on as is
+    } response_file_t;
+
+    response_file_t* files = (response_file_t*)calloc((size_t)argc, sizeof(response_file_t));
+    if (files == NULL) ARGUS_FAIL(.code = ARGUS_ERROR_NO_MEMORY, .index = -1);
+
+    // First pass: load and split every response file to count the tokens. A "--" that the scan takes as the end of
+    // the options ends them here too, so the arguments after it are passed on as they are, even if they start with '@'.
+    size_t total         = 0;
+    int    error         = 0;
+    bool   parsed        = false;
+    bool   value_next    = false;
+    bool   options_ended = false;
+    for (int i = 1; i < argc && !error; i++) {
+        files[i].expanded = !options_ended && argv[i][0] == '@';
+        if (!files[i].expanded) {
+            argus_follow_scan(argv[i], ++total, &value_next, &options_ended);
+            continue;
+        }
+        files[i].loaded = (argus_loaded_file_t*)malloc(sizeof(argus_loaded_file_t));
+        if (files[i].loaded == NULL) {
+            *err  = (argus_error_t){.code = ARGUS_ERROR_NO_MEMORY, .index = -1};
+            error = 1;
+            ARGUS_REPORT_ERROR(err);
+            break;
+        }
+        if (argus_map_file(argv[i] + 1, &files[i].loaded->file) != 0) {
+            free(files[i].loaded);
+            files[i].loaded = NULL;
+            *err  = (argus_error_t){.code = ARGUS_ERROR_RESPONSE_FILE, .index = i, .argument = argv[i], .offset = 1};
+            error = 1;
+            ARGUS_REPORT_ERROR(err);
+            break;
+        }
+        if (argus_tokenize(files[i].loaded->file.data, files[i].loaded->file.size, &files[i].count) != 0) {
+            *err  = (argus_error_t){.code = ARGUS_ERROR_UNTERMINATED_QUOTE, .index = i, .argument = argv[i],
+                                   .offset = 1};
+            error = 1;
+            ARGUS_REPORT_ERROR(err);
+        }
+        const char* token = files[i].loaded->file.data;
+        for (size_t k = 0; k < files[i].count; k++) {
+            argus_follow_scan(token, ++total, &value_next, &options_ended);
+            token += strlen(token) + 1;
+        }
+    }
+    if (!error && total >= (size_t)INT_MAX) {
+        *err  = (argus_error_t){.code = ARGUS_ERROR_TOO_MANY_ARGUMENTS, .index = -1};
+        error = 1;
+        ARGUS_REPORT_ERROR(err);
+    }
+
+    // Second pass: build the expanded vector, which points straight into argv and the loaded files
+    const char** expanded = error ? NULL : (const char**)malloc((total + 2) * sizeof(const char*));
+    if (!error && expanded == NULL) {
+        *err  = (argus_error_t){.code = ARGUS_ERROR_NO_MEMORY, .index = -1};
+        error = 1;
+        ARGUS_REPORT_ERROR(err);
+    }
+    if (!error) {
+        int n = 0;
+        expanded[n++] = argv[0];
+        for (int i = 1; i < argc; i++) {
+            if (!files[i].expanded) {
+                expanded[n++] = argv[i];
+                continue;
+            }
+            const char* token = files[i].loaded->file.data;
+            for (size_t k = 0; k < files[i].count; k++) {
+                expanded[n++] = token;
+                token += strlen(token) + 1;
+            }
+        }
+        expanded[n] = NULL;
+        parsed      = true;
+        error       = argus_parse_argv(n, expanded, args, storage, storage_size, err);
+    }
+
+    // Report the position of the failing token in argv, which is the @file argument for tokens taken from a file
+    if (error && parsed && err->index > 0) {
+        int i = 1;
+        for (int n = 1; i < argc; i++) {
+            n += files[i].expanded ? (int)files[i].count : 1;
+            if (err->index < n) break;
+        }
+        err->index = i;
+    }
+
+    // Parsed strings and error details point into the loaded files, so once parsing started they are kept in args
+    // until free_args(). That keeps err->argument valid even if a token of a file failed to parse.
+    for (int i = 1; i < argc; i++) {
+        if (files[i].loaded == NULL) continue;
+        if (parsed) {
+            files[i].loaded->next = args->argus_responses;
+            args->argus_responses = files[i].loaded;
+        } else {
+            argus_unmap_file(&files[i].loaded->file);
+            free(files[i].loaded);
+        }
+    }
+    free(expanded);
+    free(files);
+    return error;
+}
+#endif
+
+/**
+ * @brief Parse arguments into caller provided storage without printing anything
+ *
+ * @param[in]  argc         Number of command-line arguments (standard main() argc).
+ * @param[in]  argv         Array of argument strings (standard main() argv).
+ * @param[in]  args         Pointer to an default args_t struct.
+ * @param[in]  storage      Memory for the arrays of repeated arguments. If it's NULL, a single block is allocated
+ *                          and released by free_args().
+ * @param[in]  storage_size Size of storage in bytes
+ * @param[out] err          Filled with the reason parsing failed, may be NULL
+ *
+ * @retval 1 Error
+ * @retval 0 OK
+ */
+ARGUS_API int parse_args_arena_ex(const int argc, const char* const argv[], args_t* args, void* storage,
+                                  size_t storage_size, argus_error_t* err) {
+    argus_error_t ignored;
+    if (err == NULL) err = &ignored;
+    *err = (argus_error_t){.code = ARGUS_OK, .index = -1};
+#ifdef ARGUS_RESPONSE_FILES
+    for (int i = 1; argv != NULL && i < argc; i++) {
+        if (argv[i][0] == '@') return argus_parse_response_files(argc, argv, args, storage, storage_size, err);
+    }
+#endif
+    return argus_parse_argv(argc, argv, args, storage, storage_size, err);
+}
+
+/**
+ * @brief Parse arguments without printing anything
+ *
+ * @param[in]  argc  Number of command-line arguments (standard main() argc).
+ * @param[in]  argv  Array of argument strings (standard main() argv).
+ * @param[in]  args  Pointer to an default args_t struct.
+ * @param[out] err   Filled with the reason parsing failed, may be NULL
+ *
+ * @retval 1 Error
+ * @retval 0 OK
+ */
+ARGUS_API int parse_args_ex(const int argc, const char* const argv[], args_t* args, argus_error_t* err) {
+    return parse_args_arena_ex(argc, argv, args, NULL, 0, err);
+}
+
+/**
+ * @brief Reentrant parse_args_arena_ex(), for threads that parse command lines at the same time
+ *
+ * Everything the call depends on is passed in: it never prints, never expands @file arguments and leaves errno as it
+ * was, and numbers are parsed without consulting the locale. Lookup tables built on first use are published
+ * atomically, so it can be called from every thread at once. With storage for the repeated arguments it doesn't
+ * allocate either. Custom parsers and ARGUS_ON_* hooks have to be thread-safe themselves, and ARGUS_STATS counters
+ * are shared by all threads and updated atomically.
+ *
+ * @param[in]  argc         Number of command-line arguments.
+ * @param[in]  argv         Array of argument strings, starting with the program name.
+ * @param[in]  args         Pointer to an default args_t struct.
+ * @param[in]  storage      Memory for the arrays of repeated arguments. If it's NULL, a single block is allocated
+ *                          and released by free_args().
+ * @param[in]  storage_size Size of storage in bytes
+ * @param[out] err          Filled with the reason parsing failed
+ *
+ * @retval 1 Error
+ * @retval 0 OK
+ */
+ARGUS_API int parse_args_r(const int argc, const char* const argv[], args_t* args, void* storage, size_t storage_size,
+                           argus_error_t* err) {
+    const int saved_errno = errno;
+    *err                  = (argus_error_t){.code = ARGUS_OK, .index = -1};
+    const int result      = argus_parse_argv(argc, argv, args, storage, storage_size, err);
+    errno                 = saved_errno;
+    return result;
+}
+
+/**
+ * @brief Parse arguments, placing the values of repeated arguments in caller provided storage
+ *
+ * Errors are printed to stderr.
+ *
+ * @param[in]  argc         Number of command-line arguments (standard main() argc).
+ * @param[in]  argv         Array of argument strings (standard main() argv).
+ * @param[in]  args         Pointer to an default args_t struct.
+ * @param[in]  storage      Memory for the arrays of repeated arguments. If it's NULL, a single block is allocated
+ *                          and released by free_args().
+ * @param[in]  storage_size Size of storage in bytes
+ *
+ * @retval 1 Error
+ * @retval 0 OK
+ */
+ARGUS_API int parse_args_arena(const int argc, const char* const argv[], args_t* args, void* storage,
+                               size_t storage_size) {
+    argus_error_t err;
+    if (parse_args_arena_ex(argc, argv, args, storage, storage_size, &err) == 0) return 0;
+    // Custom parsers notify the user themselves
+    if (err.code != ARGUS_ERROR_PARSER) argus_print_error(&err);
+    return 1;
+}
+
+/**
+ * @brief Parse arguments
+ *
+ * Errors are printed to stderr.
+ *
+ * @param[in]  argc  Number of command-line arguments (standard main() argc).
+ * @param[in]  argv  Array of argument strings (standard main() argv).
+ * @param[in]  args  Pointer to an default args_t struct.
+ *
+ * @retval 1 Error
+ * @retval 0 OK
+ */
+ARGUS_API int parse_args(const int argc, const char* const argv[], args_t* args) {
+    return parse_args_arena(argc, argv, args, NULL, 0);
+}
+
+/**
+ * @brief Parse a whole command line given as a single string, without printing anything
+ *
+ * The line is split in place the same way response files are, so string arguments point into buf. Unlike argv the
+ * line doesn't start with the program name, and @file arguments are never expanded. Error indices count the tokens
+ * of the line from 1.
+ *
+ * @param[in,out] buf   The command line. buf[len] must be writable.
+ * @param[in]     len   Length of the command line
+ * @param[in]     args  Pointer to an default args_t struct.
+ * @param[out]    err   Filled with the reason parsing failed, may be NULL
+ *
+ * @retval 1 Error
+ * @retval 0 OK
+ */
+ARGUS_API int parse_args_line_ex(char* buf, size_t len, args_t* args, argus_error_t* err) {
+    argus_error_t ignored;
+    if (err == NULL) err = &ignored;
+    *err = (argus_error_t){.code = ARGUS_OK, .index = -1};
+
+    size_t count = 0;
+    if (argus_tokenize(buf, len, &count) != 0) ARGUS_FAIL(.code = ARGUS_ERROR_UNTERMINATED_QUOTE, .index = -1);
+    if (count > ARGUS_LINE_MAX_TOKENS) ARGUS_FAIL(.code = ARGUS_ERROR_TOO_MANY_ARGUMENTS, .index = -1);
+
+    const char* argv[ARGUS_LINE_MAX_TOKENS + 2];
+    const char* token = buf;
+    int argc = 0;
+    argv[argc++] = "";
+    for (size_t i = 0; i < count; i++) {
+        argv[argc++] = token;
+        token += strlen(token) + 1;
+    }
+    argv[argc] = NULL;
+    return argus_parse_argv(argc, argv, args, NULL, 0, err);
+}
+
+/**
+ * @brief Parse a whole command line given as a single string
+ *
+ * Same as parse_args_line_ex(), but errors are printed to stderr.
+ *
+ * @param[in,out] buf   The command line. buf[len] must be writable.
+ * @param[in]     len   Length of the command line
+ * @param[in]     args  Pointer to an default args_t struct.
+ *
+ * @retval 1 Error
+ * @retval 0 OK
+ */
+ARGUS_API int parse_args_line(char* buf, size_t len, args_t* args) {
+    argus_error_t err;
+    if (parse_args_line_ex(buf, len, args, &err) == 0) return 0;
+    // Custom parsers notify the user themselves
+    if (err.code != ARGUS_ERROR_PARSER) argus_print_error(&err);
+    return 1;
+}
+
+#ifdef ARGUS_BATCH
+// BATCH PARSING
+// Lay the arrays of a batch of n lines out back to back from base and return the bytes they take. Without a base only
+// the size is computed.
+static inline size_t argus_batch_layout(args_batch_t* out, char* base, size_t n) {
+    size_t offset = 0;
+#define ARGUS_BATCH_ARRAY(type, array)                            \
+    offset += argus_padding(offset, sizeof(type));                \
+    if (base != NULL) out->array = (type*)(void*)(base + offset); \
+    offset += n * sizeof(type);
+#define REQUIRED_ARG(type, name, ...) ARGUS_BATCH_ARRAY(type, name)
+#define OPTIONAL_ARG(type, name, ...) ARGUS_BATCH_ARRAY(type, name)
+#define BOOLEAN_ARG(name, ...) ARGUS_BATCH_ARRAY(bool, name)
+#define REPEATED_ARG(type, name, ...) ARGUS_BATCH_ARRAY(type*, name) ARGUS_BATCH_ARRAY(size_t, name##_count)
+    ARGUS_BATCH_ARRAY(argus_error_t, argus_errors)
+#ifdef REQUIRED_ARGS
+    REQUIRED_ARGS
+#endif
+#ifdef OPTIONAL_ARGS
+    OPTIONAL_ARGS
+#endif
+#ifdef BOOLEAN_ARGS
+    BOOLEAN_ARGS
+#endif
+#ifdef REPEATED_ARGS
+    REPEATED_ARGS
+    ARGUS_BATCH_ARRAY(void*, argus_storage)
+#endif
+#undef REQUIRED_ARG
+#undef OPTIONAL_ARG
+#undef BOOLEAN_ARG
+#undef REPEATED_ARG
+#undef ARGUS_BATCH_ARRAY
+    return offset;
+}
+
+// Shared by the threads of a batch, which take chunks of lines until none are left
+typedef struct {
+    char* const*         lines;
+    args_batch_t*        out;
+    ARGUS_ATOMIC(size_t) next;  // First line of the chunk handed out next
+} argus_batch_job_t;
+
+// Parse chunks of the batch until every line has been taken
+static inline void argus_batch_lines(argus_batch_job_t* job) {
+    args_batch_t* out = job->out;
+    for (;;) {
+        const size_t first = ARGUS_FETCH_ADD(&job->next, ARGUS_BATCH_CHUNK);
+        if (first >= out->argus_count) return;
+        const size_t last = out->argus_count - first < ARGUS_BATCH_CHUNK ? out->argus_count : first + ARGUS_BATCH_CHUNK;
+
+        for (size_t i = first; i < last; i++) {
+            char*  line = job->lines[i];
+            args_t args = make_default_args();
+            if (parse_args_line_ex(line, strlen(line), &args, &out->argus_errors[i]) != 0) {
+                free_args(&args);
+                args = make_default_args();
+            }
+#define REQUIRED_ARG(type, name, ...) out->name[i] = args.name;
+#define OPTIONAL_ARG(type, name, ...) out->name[i] = args.name;
+#define BOOLEAN_ARG(name, ...) out->name[i] = ARGUS_GETTER(name)(&args);
+#define REPEATED_ARG(type, name, ...) \
+    out->name[i]         = args.name; \
+    out->name##_count[i] = args.name##_count;
+#ifdef REQUIRED_ARGS
+            REQUIRED_ARGS
+#endif
+#ifdef OPTIONAL_ARGS
+            OPTIONAL_ARGS
+#endif
+#ifdef BOOLEAN_ARGS
+            BOOLEAN_ARGS
+#endif
+#ifdef REPEATED_ARGS
+            REPEATED_ARGS
+            out->argus_storage[i] = args.argus_storage;
+#endif
+#undef REQUIRED_ARG
+#undef OPTIONAL_ARG
+#undef BOOLEAN_ARG
+#undef REPEATED_ARG
+        }
+    }
+}
+
+#if defined(ARGUS_HAVE_PTHREADS) && defined(ARGUS_HAVE_ATOMICS)
+static inline void* argus_batch_worker(void* job) {
+    argus_batch_lines((argus_batch_job_t*)job);
+    return NULL;
+}
+#endif
+
+/**
+ * @brief Parse many command lines of this argument set at once, one array per argument
+ *
+ * Every line is split in place the same way parse_args_line() does, so the lines must be writable and string
+ * arguments point into them. The lines are handed out to the threads in chunks of ARGUS_BATCH_CHUNK. A line that
+ * fails to parse doesn't stop the batch: its error is kept in out->argus_errors[line] and its arguments hold the
+ * defaults. Nothing is printed. The positional sink, custom parsers and ARGUS_ON_* hooks are called from all threads.
+ *
+ * @param[in,out] lines    The command lines, each NUL terminated and without the program name
+ * @param[in]     n        Number of lines
+ * @param[out]    out      The parsed arguments, released with free_args_batch()
+ * @param[in]     nthreads Number of threads to parse with, including the calling one. 0 uses every processor
+ *                         the process may run on, see argus_cpu_count(). Without pthreads the calling thread
+ *                         parses alone.
+ *
+ * @retval 1 Some lines failed to parse, or the arrays couldn't be allocated and out->argus_count is 0
+ * @retval 0 OK
+ */
+ARGUS_API int parse_args_batch(char* const lines[], size_t n, args_batch_t* out, int nthreads) {
+    *out = (args_batch_t){.argus_count = 0};
+    // List arguments need more than the alignment malloc guarantees
+    char* block = (char*)malloc(argus_batch_layout(out, NULL, n) + ARGUS_LIST_ALIGNMENT);
+    if (block == NULL) return 1;
+    argus_batch_layout(out, block + argus_padding((uintptr_t)block, ARGUS_LIST_ALIGNMENT), n);
+    out->argus_block = block;
+    out->argus_count = n;
+
+    argus_batch_job_t job = {.lines = lines, .out = out, .next = 0};
+    // No more threads than chunks, and the calling thread is one of them
+    const size_t chunks = (n + ARGUS_BATCH_CHUNK - 1) / ARGUS_BATCH_CHUNK;
+    if (nthreads <= 0) nthreads = (int)argus_cpu_count();
+    if (nthreads > ARGUS_BATCH_MAX_THREADS) nthreads = ARGUS_BATCH_MAX_THREADS;
+    if ((size_t)nthreads > chunks) nthreads = (int)chunks;
+#if defined(ARGUS_HAVE_PTHREADS) && defined(ARGUS_HAVE_ATOMICS)
+    // If a thread can't be started the ones already running share its lines
+    pthread_t threads[ARGUS_BATCH_MAX_THREADS];
+    int       started = 0;
+    while (started < nthreads - 1 && pthread_create(&threads[started], NULL, argus_batch_worker, &job) == 0) {
+        started++;
+    }
+    argus_batch_lines(&job);
+    for (int t = 0; t < started; t++) pthread_join(threads[t], NULL);
+#else
+    argus_batch_lines(&job);
+#endif
+
+    for (size_t i = 0; i < n; i++) out->argus_failed += out->argus_errors[i].code != ARGUS_OK;
+    return out->argus_failed != 0;
+}
+
+// Release the arrays of a batch and the repeated values of its lines
+ARGUS_API void free_args_batch(args_batch_t* batch) {
+#ifdef REPEATED_ARGS
+    for (size_t i = 0; i < batch->argus_count; i++) free(batch->argus_storage[i]);
+#endif
+    free(batch->argus_block);
+    *batch = (args_batch_t){.argus_count = 0};
+}
+#endif
+
+#ifdef ARGUS_RELOAD
+// RELOADING
+// Readers load the published pointer with one acquire load and announce a quiescent point, where they hold no
+// arguments, by storing the epoch they saw into their own slot. A replaced buffer can be reused once every slot has
+// seen the epoch that replaced it. A single thread reloads, readers may come and go at any time.
+
+// The buffer that isn't published
+static inline args_t* argus_reload_shadow(args_reload_t* reload) {
+    args_t* current = ARGUS_LOAD_ACQUIRE(&reload->argus_current);
+    return current == &reload->argus_buffers[0] ? &reload->argus_buffers[1] : &reload->argus_buffers[0];
+}
+
+// Whether every reader has passed a quiescent point since the shadow buffer was replaced
+static inline bool argus_reload_drained(args_reload_t* reload) {
+    if (reload->argus_replaced == 0) return true;
+    for (int reader = 0; reader < ARGUS_RELOAD_MAX_READERS; reader++) {
+        // Read the slot with a compare and swap, which sees the latest value: a reader registering at the same time
+        // is either seen here or picks up the current epoch from it, and with that only the published buffer
+        uint64_t seen = ARGUS_LOAD_ACQUIRE(&reload->argus_readers[reader].seen);
+        while (!ARGUS_CAS(&reload->argus_readers[reader].seen, &seen, seen)) {
+        }
+        if (seen < reload->argus_replaced) return false;
+    }
+    reload->argus_replaced = 0;
+    return true;
+}
+
+/**
+ * @brief Publish the default arguments in a reloadable set of arguments without readers
+ *
+ * @param[out] reload The reloadable arguments, released with free_args_reload()
+ */
+ARGUS_API void args_reload_init(args_reload_t* reload) {
+    reload->argus_buffers[0] = make_default_args();
+    reload->argus_buffers[1] = make_default_args();
+    reload->argus_replaced   = 0;
+    for (int reader = 0; reader < ARGUS_RELOAD_MAX_READERS; reader++) {
+        ARGUS_STORE_RELEASE(&reload->argus_readers[reader].seen, ARGUS_RELOAD_UNUSED);
+    }
+    ARGUS_STORE_RELEASE(&reload->argus_epoch, 0);
+    ARGUS_STORE_RELEASE(&reload->argus_current, &reload->argus_buffers[0]);
+}
+
+/**
+ * @brief Start a reload and return the unpublished arguments, reset to the defaults
+ *
+ * Parse and validate into the returned arguments with any of the parse functions, then make them visible to the
+ * readers with args_reload_publish(). Leaving them unpublished discards them at the next call. Only one thread may
+ * reload at a time.
+ *
+ * @param[in,out] reload The reloadable arguments
+ *
+ * @return The arguments to parse into, or NULL if a reader may still use them since the last publication. Try again
+ *         once the readers have passed a quiescent point.
+ */
+ARGUS_API args_t* args_reload_begin(args_reload_t* reload) {
+    if (!argus_reload_drained(reload)) return NULL;
+    args_t* shadow = argus_reload_shadow(reload);
+    free_args(shadow);
+    *shadow = make_default_args();
+    return shadow;
+}
+
+/**
+ * @brief Publish the arguments returned by args_reload_begin()
+ *
+ * Readers see them from their next args_reload_read() on. The replaced arguments are released by the next
+ * args_reload_begin() that finds every reader past a quiescent point.
+ *
+ * @param[in,out] reload The reloadable arguments
+ */
+ARGUS_API void args_reload_publish(args_reload_t* reload) {
+    const uint64_t epoch = ARGUS_LOAD_ACQUIRE(&reload->argus_epoch) + 1;
+    ARGUS_STORE_RELEASE(&reload->argus_current, argus_reload_shadow(reload));
+    // A reader that sees the new epoch also sees the new arguments
+    ARGUS_STORE_RELEASE(&reload->argus_epoch, epoch);
+    reload->argus_replaced = epoch;
+}
+
+/**
+ * @brief Announce that the reader holds no arguments returned by args_reload_read(), e.g. between two requests
+ *
+ * @param[in,out] reload The reloadable arguments
+ * @param[in]     reader The slot returned by args_reload_register()
+ */
+ARGUS_API void args_reload_quiescent(args_reload_t* reload, int reader) {
+    ARGUS_STORE_RELEASE(&reload->argus_readers[reader].seen, ARGUS_LOAD_ACQUIRE(&reload->argus_epoch));
+}
+
+/**
+ * @brief Register the calling thread as a reader
+ *
+ * @param[in,out] reload The reloadable arguments
+ *
+ * @return The slot of the reader, or -1 if ARGUS_RELOAD_MAX_READERS readers are registered
+ */
+ARGUS_API int args_reload_register(args_reload_t* reload) {
+    for (int reader = 0; reader < ARGUS_RELOAD_MAX_READERS; reader++) {
+        uint64_t unused = ARGUS_RELOAD_UNUSED;
+        // 0 holds up every replaced buffer until the reader announces its first quiescent point
+        if (ARGUS_CAS(&reload->argus_readers[reader].seen, &unused, 0)) {
+            args_reload_quiescent(reload, reader);
+            return reader;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Get the published arguments
+ *
+ * The arguments stay valid until the reader calls args_reload_quiescent() or args_reload_unregister(). Reading them
+ * twice between two quiescent points may return different publications.
+ *
+ * @param[in] reload The reloadable arguments
+ *
+ * @return The published arguments
+ */
+ARGUS_API const args_t* args_reload_read(args_reload_t* reload) {
+    return ARGUS_LOAD_ACQUIRE(&reload->argus_current);
+}
+
+/**
+ * @brief Give up the slot of a reader, which must not use arguments it read anymore
+ *
+ * @param[in,out] reload The reloadable arguments
+ * @param[in]     reader The slot returned by args_reload_register()
+ */
+ARGUS_API void args_reload_unregister(args_reload_t* reload, int reader) {
+    ARGUS_STORE_RELEASE(&reload->argus_readers[reader].seen, ARGUS_RELOAD_UNUSED);
+}
+
+// Release both buffers once no thread reads or reloads anymore
+ARGUS_API void free_args_reload(args_reload_t* reload) {
+    free_args(&reload->argus_buffers[0]);
+    free_args(&reload->argus_buffers[1]);
+}
+#endif
+
+#if defined(ARGUS_LAZY) && defined(OPTIONAL_ARGS)
+// LAZY ACCESSORS
+// For every optional argument args_get_<name>_ex() and args_get_<name>() parse the located value on first use
+#define OPTIONAL_ARG(type, name, shortopt, longopt, arg_label, default, description, formatter, parser)         \
+    ARGUS_API int ARGUS_CONCAT(ARGUS_GETTER(name), _ex)(args_t* args, type* out, argus_error_t* err) {          \
+        argus_error_t ignored;                                                                                  \
+        if (err == NULL) err = &ignored;                                                                        \
+        *err               = (argus_error_t){.code = ARGUS_OK, .index = -1};                                    \
+        argus_lazy_t* lazy = &args->argus_lazy_##name;                                                          \
+        if (lazy->value != NULL) {                                                                              \
+            type parsed           = args->name;                                                                 \
+            const char* next_char = NULL;                                                                       \
+            ARGUS_PARSE(error, ARGUS_ID(name), parser(lazy->value, &parsed, &next_char))                        \
+            if (error != 0) {                                                                                   \
+                ARGUS_FAIL(.code = argus_value_error(error), .index = lazy->index, .argument = lazy->argument,  \
+                           .offset = (size_t)(lazy->value - lazy->argument), .option = lazy->option,            \
+                           .value_type = #type);                                                                \
+            }                                                                                                   \
+            if (next_char != NULL && *next_char != '\0') {                                                      \
+                ARGUS_FAIL(.code = ARGUS_ERROR_TRAILING_CHARACTERS, .index = lazy->index,                       \
+                           .argument = lazy->argument, .offset = (size_t)(next_char - lazy->argument),          \
+                           .option = lazy->option, .value_type = #type);                                        \
+            }                                                                                                   \
+            args->name  = parsed;                                                                               \
+            lazy->value = NULL;                                                                                 \
+        }                                                                                                       \
+        *out = args->name;                                                                                      \
+        return 0;                                                                                               \
+    }                                                                                                           \
+                                                                                                                \
+    ARGUS_API type ARGUS_GETTER(name)(args_t* args) {                                                           \
+        type value = args->name;                                                                                \
+        argus_error_t err;                                                                                      \
+        /* Custom parsers notify the user themselves */                                                         \
+        if (ARGUS_CONCAT(ARGUS_GETTER(name), _ex)(args, &value, &err) != 0 && err.code != ARGUS_ERROR_PARSER) { \
+            argus_print_error(&err);                                                                            \
+        }                                                                                                       \
+        return value;                                                                                           \
+    }
+OPTIONAL_ARGS
+#undef OPTIONAL_ARG
+#endif
+
+// Parse value into target, for values that come from outside of argv. Expects value, option (the name the value
+// was given under) and index to be in scope.
+#define ARGUS_PARSE_VALUE(type, name, target, parser)                                                     \
+    const char* next_char = NULL;                                                                         \
+    ARGUS_PARSE(error, ARGUS_ID(name), parser(value, target, &next_char))                                 \
+    if (error != 0) {                                                                                     \
+        ARGUS_FAIL(.code = argus_value_error(error), .index = index, .argument = value, .option = option, \
+                   .value_type = #type);                                                                  \
+    }                                                                                                     \
+    if (next_char != NULL && *next_char != '\0') {                                                        \
+        ARGUS_FAIL(.code = ARGUS_ERROR_TRAILING_CHARACTERS, .index = index, .argument = value,            \
+                   .offset = (size_t)(next_char - value), .option = option, .value_type = #type);         \
+    }
+
+#define ARGUS_SET_VALUE(type, name, parser)                \
+    case ARGUS_ID(name): {                                 \
+        ARGUS_PARSE_VALUE(type, name, &args->name, parser) \
+        break;                                             \
+    }
+
+// Booleans go through their setter, as they may be packed into bits
+#define ARGUS_SET_FLAG(name)                             \
+    case ARGUS_ID(name): {                               \
+        bool flag = false;                               \
+        ARGUS_PARSE_VALUE(bool, name, &flag, parse_bool) \
+        ARGUS_SETTER(name)(args, flag);                  \
+        break;                                           \
+    }
+
+#ifdef ENV_ARGS
+// ENVIRONMENT VARIABLES
+// Environment variable names indexed by option id
+#define ENV_ARG(name, env) [ARGUS_ID(name)] = {#env, sizeof(#env) - 1},
+static const argus_name_t argus_env_names[ARGUS_OPTION_COUNT + 1] = {ENV_ARGS};
+#undef ENV_ARG
+
+// Hashed the same way as long options, the table is kept at most half full
+enum { ARGUS_ENV_SLOTS = ARGUS_POW2_CEIL(2 * ARGUS_OPTION_COUNT + 2) };
+static unsigned short argus_env_slots[ARGUS_ENV_SLOTS];
+static argus_once_t argus_env_slots_ready;
+
+/**
+ * @brief Set optional and boolean arguments from the variables declared in ENV_ARGS, without printing anything
+ *
+ * The environment is walked once and every variable is looked up in a hash table. Call it between
+ * make_default_args() and parse_args() for command-line values to override environment values, which override the
+ * defaults. String arguments point into the environment.
+ *
+ * @param[in]  args  Pointer to an default args_t struct.
+ * @param[out] err   Filled with the reason parsing failed, may be NULL
+ *
+ * @retval 1 Error
+ * @retval 0 OK
+ */
+ARGUS_API int parse_env_ex(args_t* args, argus_error_t* err) {
+    argus_error_t ignored;
+    if (err == NULL) err = &ignored;
+    *err = (argus_error_t){.code = ARGUS_OK, .index = -1};
+    if (argus_once_begin(&argus_env_slots_ready)) {
+        argus_fill_slots(argus_env_names, ARGUS_OPTION_COUNT, argus_env_slots, ARGUS_ENV_SLOTS - 1);
+        argus_once_end(&argus_env_slots_ready);
+    }
+
+    for (char** entry = argus_environ; entry != NULL && *entry != NULL; entry++) {
+        size_t len;
+        const uint32_t hash = argus_hash_until(*entry, '=', &len);
+        if ((*entry)[len] != '=') continue;
+        const int id = argus_probe_slots(argus_env_names, argus_env_slots, ARGUS_ENV_SLOTS - 1, *entry, len, hash);
+        if (id < 0) continue;
+        const char* option = argus_env_names[id].name;
+        const char* value  = *entry + len + 1;
+        const int   index  = -1;
+
+#define OPTIONAL_ARG(type, name, shortopt, longopt, arg_label, default, description, formatter, parser) \
+    ARGUS_SET_VALUE(type, name, parser)
+#define BOOLEAN_ARG(name, shortopt, longopt, description) ARGUS_SET_FLAG(name)
+        switch (id) {
+#ifdef OPTIONAL_ARGS
+            OPTIONAL_ARGS
+#endif
+#ifdef BOOLEAN_ARGS
+            BOOLEAN_ARGS
+#endif
+            default:
+                break;
+        }
+#undef OPTIONAL_ARG
+#undef BOOLEAN_ARG
+    }
+    return 0;
+}
+
+/**
+ * @brief Set optional and boolean arguments from the environment variables declared in ENV_ARGS
+ *
+ * Same as parse_env_ex(), but errors are printed to stderr.
+ *
+ * @param[in]  args  Pointer to an default args_t struct.
+ *
+ * @retval 1 Error
+ * @retval 0 OK
+ */
+ARGUS_API int parse_env(args_t* args) {
+    argus_error_t err;
+    if (parse_env_ex(args, &err) == 0) return 0;
+    // Custom parsers notify the user themselves
+    if (err.code != ARGUS_ERROR_PARSER) argus_print_error(&err);
+    return 1;
+}
+#endif
+
+#ifdef ARGUS_CONFIG_FILES
+// CONFIG FILES
+/**
+ * @brief Set optional and boolean arguments from "key = value" lines, without printing anything
+ *
+ * Keys are long option names. Blank lines and lines starting with '#' or ';' are skipped, and whitespace around
+ * keys and values is ignored. The lines are terminated in place, so string arguments point into buf. Boolean
+ * arguments accept true/false, yes/no, on/off and 1/0. Error indices are line numbers.
+ *
+ * @param[in,out] buf   The config text. buf[len] must be writable.
+ * @param[in]     len   Length of the text
+ * @param[in]     args  Pointer to an default args_t struct.
+ * @param[out]    err   Filled with the reason parsing failed, may be NULL
+ *
+ * @retval 1 Error
+ * @retval 0 OK
+ */
+ARGUS_API int parse_config_buffer_ex(char* buf, size_t len, args_t* args, argus_error_t* err) {
+    argus_error_t ignored;
+    if (err == NULL) err = &ignored;
+    *err = (argus_error_t){.code = ARGUS_OK, .index = -1};
+
+    char* const end = buf + len;
+    int index       = 0;
+    for (char* line = buf; line < end;) {
+        char* eol = (char*)memchr(line, '\n', (size_t)(end - line));
+        if (eol == NULL) eol = end;
+        char* p = line;
+        line    = eol + 1;
+        index++;
+
+        while (p < eol && argus_is_blank(*p)) p++;
+        if (p == eol || *p == '#' || *p == ';') continue;
+
+        char* key = p;
+        while (p < eol && *p != '=' && !argus_is_blank(*p)) p++;
+        char* key_end = p;
+        while (p < eol && argus_is_blank(*p)) p++;
+        if (p == eol || *p != '=' || key_end == key) ARGUS_FAIL(.code = ARGUS_ERROR_CONFIG_SYNTAX, .index = index);
+        p++;
+        while (p < eol && argus_is_blank(*p)) p++;
+        char* value_end = eol;
+        while (value_end > p && argus_is_blank(value_end[-1])) value_end--;
+
+        // Both ends lie in front of anything that is still to be read
+        *key_end           = '\0';
+        *value_end         = '\0';
+        const char* option = key;
+        const char* value  = p;
+        (void)option;  // Unused without optional and boolean arguments
+        (void)value;
+        (void)args;
+
+        switch (argus_find_long(key)) {
+#define OPTIONAL_ARG(type, name, shortopt, longopt, arg_label, default, description, formatter, parser) \
+    NOT_NONE(longopt, ARGUS_SET_VALUE)(type, name, parser)
+#define BOOLEAN_ARG(name, shortopt, longopt, description) NOT_NONE(longopt, ARGUS_SET_FLAG)(name)
+#ifdef OPTIONAL_ARGS
+            OPTIONAL_ARGS
+#endif
+#ifdef BOOLEAN_ARGS
+            BOOLEAN_ARGS
+#endif
+#undef OPTIONAL_ARG
+#undef BOOLEAN_ARG
+            default:
+                ARGUS_FAIL(.code = ARGUS_ERROR_UNKNOWN_KEY, .index = index, .option = key);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Set optional and boolean arguments from a config file of "key = value" lines, without printing anything
+ *
+ * The file is loaded the same way as response files, see parse_config_buffer_ex() for its format. String
+ * arguments point into the loaded file, so it's kept in args until free_args(). If parsing fails the file is
+ * released and args is left as it was.
+ *
+ * @param[in]  path  Path of the config file
+ * @param[in]  args  Pointer to an default args_t struct.
+ * @param[out] err   Filled with the reason parsing failed, may be NULL
+ *
+ * @retval 1 Error
+ * @retval 0 OK
+ */
+ARGUS_API int parse_config_file_ex(const char* path, args_t* args, argus_error_t* err) {
+    argus_error_t ignored;
+    if (err == NULL) err = &ignored;
+    argus_loaded_file_t* loaded = (argus_loaded_file_t*)malloc(sizeof(*loaded));
+    if (loaded == NULL) ARGUS_FAIL(.code = ARGUS_ERROR_NO_MEMORY, .index = -1);
+    if (argus_map_file(path, &loaded->file) != 0) {
+        free(loaded);
+        ARGUS_FAIL(.code = ARGUS_ERROR_CONFIG_FILE, .index = -1, .argument = path);
+    }
+
+    // Values set before an error may point into the file, so they are rolled back with it
+    const args_t saved = *args;
+    if (parse_config_buffer_ex(loaded->file.data, loaded->file.size, args, err) != 0) {
+        *args = saved;
+        argus_unmap_file(&loaded->file);
+        free(loaded);
+        return 1;
+    }
+    loaded->next        = args->argus_configs;
+    args->argus_configs = loaded;
+    return 0;
+}
+
+/**
+ * @brief Set optional and boolean arguments from "key = value" lines
+ *
+ * Same as parse_config_buffer_ex(), but errors are printed to stderr.
+ *
+ * @param[in,out] buf   The config text. buf[len] must be writable.
+ * @param[in]     len   Length of the text
+ * @param[in]     args  Pointer to an default args_t struct.
+ *
+ * @retval 1 Error
+ * @retval 0 OK
+ */
+ARGUS_API int parse_config_buffer(char* buf, size_t len, args_t* args) {
+    argus_error_t err;
+    if (parse_config_buffer_ex(buf, len, args, &err) == 0) return 0;
+    // Custom parsers notify the user themselves
+    if (err.code != ARGUS_ERROR_PARSER) argus_print_error(&err);
+    return 1;
+}
+
+/**
+ * @brief Set optional and boolean arguments from a config file of "key = value" lines
+ *
+ * Same as parse_config_file_ex(), but errors are printed to stderr.
+ *
+ * @param[in]  path  Path of the config file
+ * @param[in]  args  Pointer to an default args_t struct.
+ *
+ * @retval 1 Error
+ * @retval 0 OK
+ */
+ARGUS_API int parse_config_file(const char* path, args_t* args) {
+    argus_error_t err;
+    if (parse_config_file_ex(path, args, &err) == 0) return 0;
+    // Custom parsers notify the user themselves
+    if (err.code != ARGUS_ERROR_PARSER) argus_print_error(&err);
+    return 1;
+}
+#endif
+
+// Render the help text for exec_alias into out
+static inline void argus_render_help(argus_help_buffer_t* out, const char* exec_alias) {
+    // USAGE SECTION
+    argus_help_append(out, "USAGE:\n    %s ", exec_alias);
+
+#define REQUIRED_ARG(type, name, label, ...) "<" label "> "
+
+#ifdef REQUIRED_ARGS
+    if (REQUIRED_ARG_COUNT > 0 && REQUIRED_ARG_COUNT <= 3) {
+        argus_help_append(out, "%s", REQUIRED_ARGS);
+    } else {
+        argus_help_append(out, "<ARGUMENTS> ");
+    }
+#endif
+#undef REQUIRED_ARG
+
+#define SHORT_OPT_QUICK_HELP(shortopt, arg_label) \
+    "[-" #shortopt "<" arg_label                  \
+    ">"                                           \
+    "] "
+#define OPTIONAL_ARG(type, name, shortopt, longopt, arg_label, ...) \
+    NOT_NONE(shortopt, SHORT_OPT_QUICK_HELP)(shortopt, arg_label)
+
+#define BOOLEAN_ARG_QUICK_HELP(shortopt) "[-" #shortopt "] "
+#define BOOLEAN_ARG(name, shortopt, longopt, ...) NOT_NONE(shortopt, BOOLEAN_ARG_QUICK_HELP)(shortopt)
+
+#define POSITIONAL_QUICK_HELP(arg_label) "[<" arg_label ">...] "
+#define REPEATED_QUICK_HELP(shortopt, arg_label) "[-" #shortopt "<" arg_label ">]... "
+
+#ifdef REPEATED_ARGS
+#define REPEATED_ARG(type, name, shortopt, longopt, arg_label, ...) \
+    BOTH_NONE(shortopt, longopt, POSITIONAL_QUICK_HELP)(arg_label)
+    argus_help_append(out, "%s", "" REPEATED_ARGS);
+#undef REPEATED_ARG
+#endif
+
+#ifdef POSITIONAL_SINK
+#define POSITIONAL_SINK_ARG(function, label, description) POSITIONAL_QUICK_HELP(label)
+    argus_help_append(out, "%s", "" POSITIONAL_SINK);
+#undef POSITIONAL_SINK_ARG
+#endif
+
+#if (OPTIONAL_ARG_COUNT + BOOLEAN_ARG_COUNT <= 3)
+#ifdef OPTIONAL_ARGS
+    argus_help_append(out, "%s", "" OPTIONAL_ARGS);
+#endif
+#undef OPTIONAL_ARG
+
+#ifdef BOOLEAN_ARGS
+    argus_help_append(out, "%s", "" BOOLEAN_ARGS);
+#endif
+#undef BOOLEAN_ARG
+
+#ifdef REPEATED_ARGS
+#define REPEATED_ARG(type, name, shortopt, longopt, arg_label, ...) \
+    NOT_NONE(shortopt, REPEATED_QUICK_HELP)(shortopt, arg_label)
+    argus_help_append(out, "%s", "" REPEATED_ARGS);
+#undef REPEATED_ARG
+#endif
+
+#else
+    argus_help_append(out, "[OPTIONS]");
+#endif
+
+    argus_help_append(out, "\n\n");
+
+    // Get maximum width of labels for spacing. Every argument adds a member as wide as its label, which makes
+    // the size of the union the widest label.
+#define REQUIRED_ARG(type, name, label, ...) char name[sizeof(label) + 1];
+#define OPTIONAL_ARG(type, name, shortopt, longopt, arg_label, ...) \
+    char name[6 + sizeof(#longopt) - 1 + sizeof(arg_label) - 1 + 2];
+#define BOOLEAN_ARG(name, shortopt, longopt, ...) char name[4 + sizeof(#longopt) - 1];
+#define POSITIONAL_WIDTH(name, longopt, arg_label) char name[sizeof(arg_label) - 1 + 5];
+#define REPEATED_OPT_WIDTH(name, longopt, arg_label) char name[6 + sizeof(#longopt) - 1 + sizeof(arg_label) - 1 + 5];
+#define REPEATED_ARG(type, name, shortopt, longopt, arg_label, ...)          \
+    BOTH_NONE(shortopt, longopt, POSITIONAL_WIDTH)(name, longopt, arg_label) \
+    EITHER_SET(shortopt, longopt, REPEATED_OPT_WIDTH)(name, longopt, arg_label)
+
+    union argus_label_widths {
+        char argus_none;
+#ifdef REQUIRED_ARGS
+        REQUIRED_ARGS
+#endif
+#ifdef OPTIONAL_ARGS
+        OPTIONAL_ARGS
+#endif
+#ifdef BOOLEAN_ARGS
+        BOOLEAN_ARGS
+#endif
+#ifdef REPEATED_ARGS
+        REPEATED_ARGS
+#endif
+#ifdef POSITIONAL_SINK
+#define POSITIONAL_SINK_ARG(function, label, description) char argus_sink[sizeof(label) - 1 + 5];
+        POSITIONAL_SINK
+#undef POSITIONAL_SINK_ARG
+#endif
+    };
+#undef REQUIRED_ARG
+#undef OPTIONAL_ARG
+#undef BOOLEAN_ARG
+#undef REPEATED_ARG
+
+    const int max_width = (int)sizeof(union argus_label_widths);
+    (void)max_width;  // suppress unused variable warning
+
+// ARGUMENTS SECTION
+#define REQUIRED_ARG(type, name, label, description, ...) \
+    argus_help_append(out, "    <" label ">%*s  " description "\n", max_width - ((int)sizeof(label) - 1) - 1, "");
+#define POSITIONAL_HELP(arg_label, description)                            \
+    argus_help_append(out, "    <" arg_label ">...%*s  " description "\n", \
+                      max_width - ((int)sizeof(arg_label) - 1) - 4, "");
+#define REPEATED_ARG(type, name, shortopt, longopt, arg_label, description, ...) \
+    BOTH_NONE(shortopt, longopt, POSITIONAL_HELP)(arg_label, description)
+
+#define ARGUS_PLUS_ONE(...) +1
+#ifdef REPEATED_ARGS
+#define REPEATED_ARG_IS_POSITIONAL(type, name, shortopt, longopt, ...) \
+    BOTH_NONE(shortopt, longopt, ARGUS_PLUS_ONE)()
+#else
+#define REPEATED_ARG_IS_POSITIONAL(...)
+#endif
+
+#if defined(REQUIRED_ARGS) || defined(REPEATED_ARGS) || defined(POSITIONAL_SINK)
+#undef REPEATED_ARG
+#define REPEATED_ARG REPEATED_ARG_IS_POSITIONAL
+    const int positional_count = 0
+#ifdef REPEATED_ARGS
+        REPEATED_ARGS
+#endif
+        ;
+#undef REPEATED_ARG
+#define REPEATED_ARG(type, name, shortopt, longopt, arg_label, description, ...) \
+    BOTH_NONE(shortopt, longopt, POSITIONAL_HELP)(arg_label, description)
+#define POSITIONAL_SINK_ARG(function, label, description) POSITIONAL_HELP(label, description)
+#ifdef POSITIONAL_SINK
+    const int sink_count = 1;
+#else
+    const int sink_count = 0;
+#endif
+
+    if (REQUIRED_ARG_COUNT + positional_count + sink_count > 0) {
+        argus_help_append(out, "ARGUMENTS:\n");
+#ifdef REQUIRED_ARGS
+        REQUIRED_ARGS
+#endif
+#ifdef REPEATED_ARGS
+        REPEATED_ARGS
+#endif
+#ifdef POSITIONAL_SINK
+        POSITIONAL_SINK
+#endif
+        argus_help_append(out, "\n");
+    }
+#endif
+#undef REQUIRED_ARG
+#undef REPEATED_ARG
+#undef POSITIONAL_SINK_ARG
+#undef REPEATED_ARG_IS_POSITIONAL
+
+#if defined(OPTIONAL_ARGS) || defined(BOOLEAN_ARGS)
+    argus_help_append(out, "OPTIONS:\n");
+#elif defined(REPEATED_ARGS)
+    if (REPEATED_ARG_COUNT > positional_count) argus_help_append(out, "OPTIONS:\n");
+#endif
+
+#define SHORT_HELP(shortopt) "-" #shortopt
+#define LONG_HELP(longopt) "--" #longopt
+#define WIDTH(keyword) ((int)sizeof(#keyword) - 1)
+
+#define ARGUS_IDENTITY(...) __VA_ARGS__
+#define SECOND_SET(second, MACRO) NOT_NONE(second, ARGUS_IDENTITY)(MACRO)
+#define BOTH_SET(first, second, MACRO) NOT_NONE(first, SECOND_SET)(second, MACRO)
+
+    // Calculate the width of a boolean argument
+#define CALC_WIDTH(shortopt, longopt)                                                         \
+    max_width NOT_NONE(shortopt, -1 - WIDTH)(shortopt) NOT_NONE(longopt, -2 - WIDTH)(longopt) \
+            BOTH_SET(shortopt, longopt, -2) +                                                 \
+        1
+
+    // Calculate the width of the optional argument
+#define CALC_OPT_WIDTH(shortopt, longopt, arg_label) CALC_WIDTH(shortopt, longopt) - ((int)sizeof(arg_label) - 1) - 3
+
+#define ARGUS_OPTIONAL_HELP(shortopt, longopt, arg_label, default, description, formatter) \
+    argus_help_append(out, "    "                                   /* line break */       \
+           NOT_NONE(shortopt, SHORT_HELP)(shortopt) /* line break */                       \
+           BOTH_SET(shortopt, longopt, ", ")        /* line break */                       \
+           NOT_NONE(longopt, LONG_HELP)(longopt)    /* line break */                       \
+           " <" arg_label                                                                  \
+           ">"                                                                             \
+           "%*s  " description " (default: " formatter ")\n",                              \
+           CALC_OPT_WIDTH(shortopt, longopt, arg_label), "", default);
+
+    // A thread count that defaults to 0 shows the default as "auto", which is what it resolves like
+#define ARGUS_THREADS_HELP_parse_threads ,
+#define ARGUS_THREADS_HELP(shortopt, longopt, arg_label, default, description, formatter)      \
+    if ((default) == 0) {                                                                      \
+        ARGUS_OPTIONAL_HELP(shortopt, longopt, arg_label, "auto", description, "%s")           \
+    } else {                                                                                   \
+        ARGUS_OPTIONAL_HELP(shortopt, longopt, arg_label, default, description, formatter)     \
     }
-#define OPTIONAL_ARG(type, name, shortopt, longopt, arg_label, ...) \
-    {                                                               \
-        int len = 6 + strlen(#longopt) + strlen(arg_label) + 2;     \
-        if (len > max_width) max_width = len;                       \
+
+#define OPTIONAL_ARG(type, name, shortopt, longopt, arg_label, default, description, formatter, parser) \
+    EVAL_SELECT_3RD((ARGUS_THREADS_HELP_##parser, ARGUS_THREADS_HELP, ARGUS_OPTIONAL_HELP))             \
+    (shortopt, longopt, arg_label, default, description, formatter)
+
+#define ARGUS_LIST_HELP(type, name, shortopt, longopt, arg_label, description, ...)  \
+    argus_help_append(out, "    "                                   /* line break */ \
+           NOT_NONE(shortopt, SHORT_HELP)(shortopt) /* line break */                 \
+           BOTH_SET(shortopt, longopt, ", ")        /* line break */                 \
+           NOT_NONE(longopt, LONG_HELP)(longopt)    /* line break */                 \
+           " <" arg_label ">"                       /* line break */                 \
+           "%*s  " description "\n",                                                 \
+           CALC_OPT_WIDTH(shortopt, longopt, arg_label), "");
+#undef OPTIONAL_LIST_ARG
+#define OPTIONAL_LIST_ARG ARGUS_LIST_HELP
+
+#define BOOLEAN_ARG(name, shortopt, longopt, description)                            \
+    argus_help_append(out, "    "                                   /* line break */ \
+           NOT_NONE(shortopt, SHORT_HELP)(shortopt) /* line break */                 \
+           BOTH_SET(shortopt, longopt, ", ")        /* line break */                 \
+           NOT_NONE(longopt, LONG_HELP)(longopt)    /* line break */                 \
+           "%*s  " description "\n",                                                 \
+           CALC_WIDTH(shortopt, longopt), "");
+
+#ifdef OPTIONAL_ARGS
+    OPTIONAL_ARGS
+#endif
+#undef OPTIONAL_ARG
+#undef ARGUS_OPTIONAL_HELP
+#undef ARGUS_THREADS_HELP_parse_threads
+#undef ARGUS_THREADS_HELP
+#undef OPTIONAL_LIST_ARG
+#define OPTIONAL_LIST_ARG ARGUS_LIST_AS_OPTIONAL
+
+#ifdef BOOLEAN_ARGS
+    BOOLEAN_ARGS
+#endif
+#undef BOOLEAN_ARG
+
+#define REPEATED_OPT_HELP(shortopt, longopt, arg_label, description)                 \
+    argus_help_append(out, "    "                                   /* line break */ \
+           NOT_NONE(shortopt, SHORT_HELP)(shortopt) /* line break */                 \
+           BOTH_SET(shortopt, longopt, ", ")        /* line break */                 \
+           NOT_NONE(longopt, LONG_HELP)(longopt)    /* line break */                 \
+           " <" arg_label ">..."                    /* line break */                 \
+           "%*s  " description "\n",                                                 \
+           CALC_OPT_WIDTH(shortopt, longopt, arg_label) - 3, "");
+#define REPEATED_ARG(type, name, shortopt, longopt, arg_label, description, ...) \
+    EITHER_SET(shortopt, longopt, REPEATED_OPT_HELP)(shortopt, longopt, arg_label, description)
+
+#ifdef REPEATED_ARGS
+    REPEATED_ARGS
+#endif
+#undef REPEATED_ARG
+}
+
+static char argus_help_static[ARGUS_HELP_BUFFER_SIZE];
+static argus_help_buffer_t argus_help = {argus_help_static, sizeof(argus_help_static), 0};
+static size_t argus_help_alias_length;  // Length of the alias the cached text was rendered for
+
+// The alias is part of the usage line, so the cached text is only reused if it was rendered for the same alias. An
+// alias may contain spaces, e.g. "program command", so its length is compared as well.
+static inline bool argus_help_rendered_for(const char* exec_alias) {
+    const size_t prefix = sizeof("USAGE:\n    ") - 1;
+    const size_t len    = strlen(exec_alias);
+    return len == argus_help_alias_length && argus_help.length > prefix + len &&
+           strncmp(argus_help.data + prefix, exec_alias, len) == 0;
+}
+
+/**
+ * @brief Get the help text print_help() writes
+ *
+ * The text is rendered once and cached until it's requested for a different alias.
+ *
+ * @param[in]  exec_alias  Command used to launch program, e.g., argv[0]
+ *
+ * @return NUL terminated help text, valid until the next call with a different alias
+ */
+ARGUS_API const char* argus_help_string(const char* exec_alias) {
+    if (argus_help.length > 0 && argus_help_rendered_for(exec_alias)) return argus_help.data;
+
+#ifdef ARGUS_STATS
+    const uint64_t start = argus_now_ns();
+    ARGUS_COUNT(help_renders);
+#endif
+    argus_help.length       = 0;
+    argus_help_alias_length = strlen(exec_alias);
+    argus_render_help(&argus_help, exec_alias);
+    if (argus_help.length >= argus_help.size) {
+        char* data = (char*)malloc(argus_help.length + 1);
+        if (data == NULL) {
+            argus_help.length = argus_help.size - 1;
+        } else {
+            if (argus_help.data != argus_help_static) free(argus_help.data);
+            argus_help.data   = data;
+            argus_help.size   = argus_help.length + 1;
+            argus_help.length = 0;
+            argus_render_help(&argus_help, exec_alias);
+        }
     }
+#ifdef ARGUS_STATS
+    ARGUS_ADD(help_ns, argus_now_ns() - start);
+#endif
+    return argus_help.data;
+}
+
+// Display help string, given command used to launch program, e.g., argv[0]
+ARGUS_API void print_help(const char* exec_alias) {
+    const char* help = argus_help_string(exec_alias);
+    argus_write_text(ARGUS_STDOUT, help, argus_help.length);
+}
+
+// SHELL COMPLETION
+// Every spelling of every option, in declaration order. The empty string keeps the array from being empty.
+#define ARGUS_SHORT_SPELLING(shortopt) "-" #shortopt,
+#define ARGUS_LONG_SPELLING(longopt) "--" #longopt,
+#define OPTIONAL_ARG(type, name, shortopt, longopt, ...) \
+    NOT_NONE(shortopt, ARGUS_SHORT_SPELLING)(shortopt) NOT_NONE(longopt, ARGUS_LONG_SPELLING)(longopt)
 #define BOOLEAN_ARG(name, shortopt, longopt, ...) \
-    {                                             \
-        int len = 4 + strlen(#longopt);           \
-        if (len > max_width) max_width = len;     \
+    NOT_NONE(shortopt, ARGUS_SHORT_SPELLING)(shortopt) NOT_NONE(longopt, ARGUS_LONG_SPELLING)(longopt)
+#define REPEATED_ARG(type, name, shortopt, longopt, ...) \
+    NOT_NONE(shortopt, ARGUS_SHORT_SPELLING)(shortopt) NOT_NONE(longopt, ARGUS_LONG_SPELLING)(longopt)
+static const char* const argus_spellings[] = {
+#ifdef OPTIONAL_ARGS
+    OPTIONAL_ARGS
+#endif
+#ifdef BOOLEAN_ARGS
+    BOOLEAN_ARGS
+#endif
+#ifdef REPEATED_ARGS
+    REPEATED_ARGS
+#endif
+    ""};
+#undef OPTIONAL_ARG
+#undef BOOLEAN_ARG
+#undef REPEATED_ARG
+static const size_t argus_spelling_count = sizeof(argus_spellings) / sizeof(argus_spellings[0]) - 1;
+
+// The spellings in strcmp() order, sorted on first use
+static const char* argus_sorted_spellings[sizeof(argus_spellings) / sizeof(argus_spellings[0])];
+static argus_once_t argus_sorted_spellings_ready;
+
+static inline void argus_sort_spellings(void) {
+    for (size_t i = 0; i < argus_spelling_count; i++) {
+        const char* spelling = argus_spellings[i];
+        size_t j             = i;
+        for (; j > 0 && strcmp(argus_sorted_spellings[j - 1], spelling) > 0; j--) {
+            argus_sorted_spellings[j] = argus_sorted_spellings[j - 1];
+        }
+        argus_sorted_spellings[j] = spelling;
+    }
+    argus_once_end(&argus_sorted_spellings_ready);
+}
+
+/**
+ * @brief Answer "program --argus-complete <prefix>" with the options that start with prefix, one per line
+ *
+ * Call it first thing in main() and return if it answered, as it's called on every tab press. It only reads argv
+ * and writes to stdout, and answers from a sorted table with a binary search.
+ *
+ * @param[in]  argc  Number of command-line arguments (standard main() argc).
+ * @param[in]  argv  Array of argument strings (standard main() argv).
+ *
+ * @retval 1 argv was a completion request, which has been answered
+ * @retval 0 argv is an ordinary command line
+ */
+ARGUS_API int complete_args(const int argc, const char* const argv[]) {
+    if (argc < 2 || argv == NULL || strcmp(argv[1], "--argus-complete") != 0) return 0;
+    const char* prefix = argc > 2 ? argv[2] : "";
+    const size_t len   = strlen(prefix);
+    if (argus_once_begin(&argus_sorted_spellings_ready)) argus_sort_spellings();
+
+    // The matches are the run of spellings starting at the first one not below prefix
+    size_t low = 0, high = argus_spelling_count;
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        if (strcmp(argus_sorted_spellings[mid], prefix) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    for (; low < argus_spelling_count && strncmp(argus_sorted_spellings[low], prefix, len) == 0; low++) {
+        argus_print(ARGUS_STDOUT, "%s\n", argus_sorted_spellings[low]);
+    }
+    argus_flush(ARGUS_STDOUT);
+    return 1;
+}
+
+/**
+ * @brief Print a completion script for a shell to stdout
+ *
+ * The bash script asks the program through complete_args(), the zsh and fish ones list the options with their
+ * descriptions, e.g. "program --completion fish > ~/.config/fish/completions/program.fish".
+ *
+ * @param[in]  shell_name "bash", "zsh" or "fish"
+ * @param[in]  exec_name  Name the program is run under
+ *
+ * @retval 1 Unknown shell
+ * @retval 0 OK
+ */
+ARGUS_API int print_completion(const char* shell_name, const char* exec_name) {
+    argus_shell_t shell;
+    if (strcmp(shell_name, "bash") == 0) {
+        shell = ARGUS_SHELL_BASH;
+    } else if (strcmp(shell_name, "zsh") == 0) {
+        shell = ARGUS_SHELL_ZSH;
+    } else if (strcmp(shell_name, "fish") == 0) {
+        shell = ARGUS_SHELL_FISH;
+    } else {
+        return 1;
+    }
+
+    const char* prologue[] = {"_argus_", "#compdef ", ""};
+    argus_print(ARGUS_STDOUT, "%s", prologue[shell]);
+    if (shell == ARGUS_SHELL_BASH) {
+        argus_print_identifier(exec_name);
+        argus_print(ARGUS_STDOUT, "%s",
+                    "() {\n    [[ $2 == -* ]] && mapfile -t COMPREPLY < <(\"$1\" --argus-complete \"$2\")\n}\n"
+                    "complete -o default -F _argus_");
+        argus_print_identifier(exec_name);
+        argus_print(ARGUS_STDOUT, " %s\n", exec_name);
+        argus_flush(ARGUS_STDOUT);
+        return 0;
+    }
+    if (shell == ARGUS_SHELL_ZSH) {
+        argus_print(ARGUS_STDOUT, "%s\n_argus_", exec_name);
+        argus_print_identifier(exec_name);
+        argus_print(ARGUS_STDOUT, "%s", "() {\n    _arguments -s \\\n");
+    }
+
+#define ARGUS_NO_SPELLING(...) NULL
+#define ARGUS_SHORT_STRING(shortopt) "-" #shortopt
+#define ARGUS_LONG_STRING(longopt) "--" #longopt
+#define ARGUS_COMPLETE_OPTION(shortopt, longopt, description, label, repeated)                              \
+    argus_print_completion_option(shell, exec_name,                                                         \
+                                  NOT_NONE_ELSE(shortopt, ARGUS_SHORT_STRING, ARGUS_NO_SPELLING)(shortopt), \
+                                  NOT_NONE_ELSE(longopt, ARGUS_LONG_STRING, ARGUS_NO_SPELLING)(longopt),    \
+                                  description, label, repeated);
+#define OPTIONAL_ARG(type, name, shortopt, longopt, arg_label, default, description, ...) \
+    ARGUS_COMPLETE_OPTION(shortopt, longopt, description, arg_label, false)
+#define BOOLEAN_ARG(name, shortopt, longopt, description) \
+    ARGUS_COMPLETE_OPTION(shortopt, longopt, description, NULL, false)
+#define REPEATED_ARG(type, name, shortopt, longopt, arg_label, description, ...) \
+    EITHER_SET(shortopt, longopt, ARGUS_COMPLETE_OPTION)(shortopt, longopt, description, arg_label, true)
+#ifdef OPTIONAL_ARGS
+    OPTIONAL_ARGS
+#endif
+#ifdef BOOLEAN_ARGS
+    BOOLEAN_ARGS
+#endif
+#ifdef REPEATED_ARGS
+    REPEATED_ARGS
+#endif
+#undef OPTIONAL_ARG
+#undef BOOLEAN_ARG
+#undef REPEATED_ARG
+
+    if (shell == ARGUS_SHELL_ZSH) {
+        argus_print(ARGUS_STDOUT, "%s", "        '*:file:_files'\n}\ncompdef _argus_");
+        argus_print_identifier(exec_name);
+        argus_print(ARGUS_STDOUT, " %s\n", exec_name);
     }
+    argus_flush(ARGUS_STDOUT);
+    return 0;
+}
 
+// SNAPSHOT
+// Size of args_t and a hash of the declarations, so snapshots of other argument sets are rejected
+ARGUS_API uint64_t argus_layout(void) {
+#define REQUIRED_ARG(type, name, ...) #type " " #name ";"
+#define OPTIONAL_ARG(type, name, ...) #type " " #name ";"
+#define BOOLEAN_ARG(name, ...) "bool " #name ";"
+#define REPEATED_ARG(type, name, ...) #type "* " #name ";"
+    static const char declarations[] = ""
 #ifdef REQUIRED_ARGS
-    REQUIRED_ARGS
+        REQUIRED_ARGS
+#endif
+#ifdef OPTIONAL_ARGS
+            OPTIONAL_ARGS
+#endif
+#ifdef BOOLEAN_ARGS
+                BOOLEAN_ARGS
+#endif
+#ifdef REPEATED_ARGS
+                    REPEATED_ARGS
 #endif
+        ;
 #undef REQUIRED_ARG
+#undef OPTIONAL_ARG
+#undef BOOLEAN_ARG
+#undef REPEATED_ARG
+    size_t len;
+    return (uint64_t)sizeof(args_t) << 32 | argus_hash(declarations, &len);
+}
+
+/**
+ * @brief Write a binary snapshot of args into buf
+ *
+ * The snapshot can be handed to another process running the same program, e.g. through shared memory or a pipe,
+ * which restores it with argus_deserialize() instead of parsing again. Nothing is written if it doesn't fit, so
+ * argus_serialize(args, NULL, 0) returns the size to allocate. In ARGUS_LAZY mode only the values that have been
+ * read through their accessors are stored.
+ *
+ * @param[in]  args  The parsed arguments
+ * @param[out] buf   Buffer for the snapshot, may be NULL if size is 0
+ * @param[in]  size  Size of buf in bytes
+ *
+ * @return Size of the snapshot in bytes, it was written if it's at most size
+ */
+ARGUS_API size_t argus_serialize(const args_t* args, void* buf, size_t size) {
+    argus_writer_t out = {(unsigned char*)buf, buf == NULL ? 0 : size, 0};
+    argus_snapshot_header_t header = {ARGUS_SNAPSHOT_MAGIC, ARGUS_SNAPSHOT_VERSION, argus_layout(), 0};
+    argus_write(&out, &header, sizeof(header));
+
+#define REQUIRED_ARG(type, name, label, description, parser) ARGUS_WRITE_VALUE(type, args->name, parser)
+#define OPTIONAL_ARG(type, name, shortopt, longopt, arg_label, default, description, formatter, parser) \
+    ARGUS_WRITE_VALUE(type, args->name, parser)
+#define BOOLEAN_ARG(name, ...)                                       \
+    {                                                                \
+        const unsigned char flag = ARGUS_GETTER(name)(args) ? 1 : 0; \
+        argus_write(&out, &flag, 1);                                 \
+    }
+#define REPEATED_ARG(type, name, shortopt, longopt, arg_label, description, parser) \
+    {                                                                               \
+        const uint64_t count = (uint64_t)args->name##_count;                        \
+        argus_write(&out, &count, sizeof(count));                                   \
+        for (size_t k = 0; k < args->name##_count; k++) {                           \
+            ARGUS_WRITE_VALUE(type, args->name[k], parser)                          \
+        }                                                                           \
+    }
+#ifdef REQUIRED_ARGS
+    REQUIRED_ARGS
+#endif
 #ifdef OPTIONAL_ARGS
     OPTIONAL_ARGS
 #endif
-#undef OPTIONAL_ARG
 #ifdef BOOLEAN_ARGS
     BOOLEAN_ARGS
 #endif
+#ifdef REPEATED_ARGS
+    REPEATED_ARGS
+#endif
+#undef REQUIRED_ARG
+#undef OPTIONAL_ARG
 #undef BOOLEAN_ARG
+#undef REPEATED_ARG
 
-// ARGUMENTS SECTION
-#define REQUIRED_ARG(type, name, label, description, ...) \
-    printf("    <" label ">%*s  " description "\n", max_width - (int)strlen(label) - 1, "");
+    // The size is only known at the end
+    header.size = (uint64_t)out.length;
+    if (out.length <= out.size) memcpy(out.data, &header, sizeof(header));
+    (void)args;  // Unused without arguments
+    return out.length;
+}
+
+/**
+ * @brief Restore arguments from a snapshot taken by argus_serialize()
+ *
+ * String arguments point into buf, which has to outlive args. The arrays of repeated arguments are copied into a
+ * single block that free_args() releases.
+ *
+ * @param[in]  buf   The snapshot
+ * @param[in]  size  Size of buf in bytes, at least the size of the snapshot
+ * @param[in]  args  Pointer to an default args_t struct.
+ * @param[out] err   Filled with the reason restoring failed, may be NULL
+ *
+ * @retval 1 Error
+ * @retval 0 OK
+ */
+ARGUS_API int argus_deserialize(const void* buf, size_t size, args_t* args, argus_error_t* err) {
+    argus_error_t ignored;
+    if (err == NULL) err = &ignored;
+    *err = (argus_error_t){.code = ARGUS_OK, .index = -1};
+
+    argus_reader_t in = {(const unsigned char*)buf, buf == NULL ? 0 : size, 0};
+    argus_snapshot_header_t header;
+    if (argus_read(&in, &header, sizeof(header)) != 0 || header.magic != ARGUS_SNAPSHOT_MAGIC ||
+        header.version != ARGUS_SNAPSHOT_VERSION || header.layout != argus_layout() || header.size > in.size) {
+        ARGUS_FAIL(.code = ARGUS_ERROR_BAD_SNAPSHOT, .index = -1);
+    }
+    in.size = (size_t)header.size;
 
+#define REQUIRED_ARG(type, name, label, description, parser) ARGUS_READ_VALUE(type, &args->name, parser)
+#define OPTIONAL_ARG(type, name, shortopt, longopt, arg_label, default, description, formatter, parser) \
+    ARGUS_READ_VALUE(type, &args->name, parser)                                                         \
+    ARGUS_CHECK_VALUE(args->name, parser)
+#define BOOLEAN_ARG(name, ...)                                         \
+    {                                                                  \
+        unsigned char flag;                                            \
+        if (argus_read(&in, &flag, 1) != 0 || flag > 1) {              \
+            ARGUS_FAIL(.code = ARGUS_ERROR_BAD_SNAPSHOT, .index = -1); \
+        }                                                              \
+        ARGUS_SETTER(name)(args, flag == 1);                           \
+    }
 #ifdef REQUIRED_ARGS
-    printf("ARGUMENTS:\n");
     REQUIRED_ARGS
-    printf("\n");
+#endif
+#ifdef OPTIONAL_ARGS
+    OPTIONAL_ARGS
+#endif
+#ifdef BOOLEAN_ARGS
+    BOOLEAN_ARGS
 #endif
 #undef REQUIRED_ARG
+#undef OPTIONAL_ARG
+#undef BOOLEAN_ARG
 
-#if defined(OPTIONAL_ARGS) || defined(BOOLEAN_ARGS)
-    printf("OPTIONS:\n");
+#ifdef REPEATED_ARGS
+    // First pass: check the arrays and measure them, second pass: copy them into one block. The second pass reads
+    // bytes the first one accepted, so it can't fail.
+    const size_t start = in.offset;
+    char*        base  = NULL;
+    for (int pass = 0; pass < 2; pass++) {
+        in.offset     = start;
+        size_t offset = 0;
+#define REPEATED_ARG(type, name, shortopt, longopt, arg_label, description, parser)       \
+    {                                                                                     \
+        uint64_t count;                                                                   \
+        /* Every value takes at least a byte, which bounds the count */                   \
+        if (argus_read(&in, &count, sizeof(count)) != 0 || count > in.size - in.offset) { \
+            free(base);                                                                   \
+            ARGUS_FAIL(.code = ARGUS_ERROR_BAD_SNAPSHOT, .index = -1);                    \
+        }                                                                                 \
+        offset += argus_padding(offset, sizeof(type));                                    \
+        type* values = base != NULL ? (type*)(base + offset) : NULL;                      \
+        for (size_t k = 0; k < (size_t)count; k++) {                                      \
+            type scratch;                                                                 \
+            type* target = values != NULL ? &values[k] : &scratch;                        \
+            ARGUS_READ_VALUE(type, target, parser)                                        \
+        }                                                                                 \
+        if (base != NULL) {                                                               \
+            args->name         = count > 0 ? values : NULL;                               \
+            args->name##_count = (size_t)count;                                           \
+        }                                                                                 \
+        offset += (size_t)count * sizeof(type);                                           \
+    }
+        REPEATED_ARGS
+#undef REPEATED_ARG
+        if (pass == 1 || offset == 0) break;
+        base = (char*)malloc(offset);
+        if (base == NULL) ARGUS_FAIL(.code = ARGUS_ERROR_NO_MEMORY, .index = -1);
+    }
+    free(args->argus_storage);
+    args->argus_storage = base;
 #endif
+    return 0;
+}
 
-#define SHORT_HELP(shortopt) "-" #shortopt
-#define LONG_HELP(longopt) "--" #longopt
-#define WIDTH(keyword) (int)strlen(#keyword)
-
-#define SECOND_SET(second, MACRO) NOT_NONE(second, MACRO)
-#define BOTH_SET(first, second, MACRO) NOT_NONE(first, SECOND_SET)(second, MACRO)
+/**
+ * @brief Build the shortest argv that parses back into args
+ *
+ * Only values that differ from their defaults are written, with the long spelling of an option where it has one,
+ * e.g. for re-executing the program with the same arguments. Values of custom parsers can't be written unless
+ * they keep their defaults. Values of positional arguments that start with '-' aren't told apart from options.
+ *
+ * @param[in]  args       The parsed arguments
+ * @param[in]  exec_name  The first argument, e.g. argv[0]
+ * @param[out] argc       Number of arguments
+ * @param[out] argv       The arguments, terminated by NULL, to be released with free(*argv)
+ * @param[out] err        Filled with the reason building failed, may be NULL
+ *
+ * @retval 1 Error
+ * @retval 0 OK
+ */
+ARGUS_API int argus_to_argv(const args_t* args, const char* exec_name, int* argc, char*** argv, argus_error_t* err) {
+    argus_error_t ignored;
+    if (err == NULL) err = &ignored;
+    *err = (argus_error_t){.code = ARGUS_OK, .index = -1};
 
-    // Calculate the width of a boolean argument
-#define CALC_WIDTH(shortopt, longopt)                                                         \
-    max_width NOT_NONE(shortopt, -1 - WIDTH)(shortopt) NOT_NONE(longopt, -2 - WIDTH)(longopt) \
-            BOTH_SET(shortopt, longopt, -2) +                                                 \
-        1
+    const args_t defaults = make_default_args();
+    argus_argv_builder_t builder = {0};
+    for (int pass = 0; pass < 2; pass++) {
+        if (pass == 1) {
+            // A single block holds the pointers followed by the text
+            const size_t pointers = ((size_t)builder.argc + 1) * sizeof(char*);
+            char*        block    = (char*)malloc(pointers + builder.length);
+            if (block == NULL) ARGUS_FAIL(.code = ARGUS_ERROR_NO_MEMORY, .index = -1);
+            builder = (argus_argv_builder_t){(char**)block, block + pointers, builder.length, 0, 0, 0};
+        }
+        argus_argv_append(&builder, "%s", exec_name);
+        argus_argv_end(&builder);
 
-    // Calculate the width of the optional argument
-#define CALC_OPT_WIDTH(shortopt, longopt, arg_label) CALC_WIDTH(shortopt, longopt) - (int)strlen(arg_label) - 3
-
-#define OPTIONAL_ARG(type, name, shortopt, longopt, arg_label, default, description, formatter, ...) \
-    printf("    "                                   /* line break */                                 \
-           NOT_NONE(shortopt, SHORT_HELP)(shortopt) /* line break */                                 \
-           BOTH_SET(shortopt, longopt, ", ")        /* line break */                                 \
-           NOT_NONE(longopt, LONG_HELP)(longopt)    /* line break */                                 \
-           " <" arg_label                                                                            \
-           ">"                                                                                       \
-           "%*s  " description " (default: " formatter ")\n",                                        \
-           CALC_OPT_WIDTH(shortopt, longopt, arg_label), "", default);
+#define REQUIRED_ARG(type, name, label, description, parser) ARGUS_PUSH_VALUE(parser, args->name, "<" label ">")
+#define OPTIONAL_ARG(type, name, shortopt, longopt, arg_label, default, description, formatter, parser) \
+    if (ARGUS_VALUE_DIFFERS(args->name, defaults.name, parser)) {                                       \
+        NOT_NONE_ELSE(longopt, ARGUS_PUSH_LONG, ARGUS_PUSH_SHORT)(shortopt, longopt)                    \
+        ARGUS_PUSH_VALUE(parser, args->name, ARGUS_OPTION_NAME(shortopt, longopt))                      \
+    }
+#define BOOLEAN_ARG(name, shortopt, longopt, description)                                 \
+    if (ARGUS_GETTER(name)(args)) {                                                       \
+        NOT_NONE_ELSE(longopt, ARGUS_PUSH_LONG, ARGUS_PUSH_SHORT_FLAG)(shortopt, longopt) \
+    }
+#define ARGUS_PUSH_REPEATED(type, name, shortopt, longopt, parser)                    \
+    for (size_t i = 0; i < args->name##_count; i++) {                                 \
+        NOT_NONE_ELSE(longopt, ARGUS_PUSH_LONG, ARGUS_PUSH_SHORT)(shortopt, longopt)  \
+        ARGUS_PUSH_VALUE(parser, args->name[i], ARGUS_OPTION_NAME(shortopt, longopt)) \
+    }
+#define REPEATED_ARG(type, name, shortopt, longopt, arg_label, description, parser) \
+    EITHER_SET(shortopt, longopt, ARGUS_PUSH_REPEATED)(type, name, shortopt, longopt, parser)
+#ifdef REQUIRED_ARGS
+        REQUIRED_ARGS
+#endif
+#ifdef OPTIONAL_ARGS
+        OPTIONAL_ARGS
+#endif
+#ifdef BOOLEAN_ARGS
+        BOOLEAN_ARGS
+#endif
+#ifdef REPEATED_ARGS
+        REPEATED_ARGS
+#undef REPEATED_ARG
 
-#define BOOLEAN_ARG(name, shortopt, longopt, description)            \
-    printf("    "                                   /* line break */ \
-           NOT_NONE(shortopt, SHORT_HELP)(shortopt) /* line break */ \
-           BOTH_SET(shortopt, longopt, ", ")        /* line break */ \
-           NOT_NONE(longopt, LONG_HELP)(longopt)    /* line break */ \
-           "%*s  " description "\n",                                 \
-           CALC_WIDTH(shortopt, longopt), "");
+        // Positional values go last behind "--", so they can't be read as options or as the value of one
+#define ARGUS_PUSH_POSITIONAL(type, name, arg_label, parser)       \
+    if (args->name##_count > 0) {                                  \
+        argus_argv_append(&builder, "--");                         \
+        argus_argv_end(&builder);                                  \
+    }                                                              \
+    for (size_t i = 0; i < args->name##_count; i++) {              \
+        ARGUS_PUSH_VALUE(parser, args->name[i], "<" arg_label ">") \
+    }
+#define REPEATED_ARG(type, name, shortopt, longopt, arg_label, description, parser) \
+    BOTH_NONE(shortopt, longopt, ARGUS_PUSH_POSITIONAL)(type, name, arg_label, parser)
+        REPEATED_ARGS
+#endif
+#undef REQUIRED_ARG
+#undef OPTIONAL_ARG
+#undef BOOLEAN_ARG
+#undef REPEATED_ARG
+    }
+    builder.argv[builder.argc] = NULL;
+    *argc                      = builder.argc;
+    *argv                      = builder.argv;
+    (void)defaults;  // Unused without optional arguments
+    (void)args;
+    return 0;
+}
 
+// DIFF
+/**
+ * @brief Find the fields that differ between two parsed argument sets, e.g. before and after a reload
+ *
+ * Strings are compared with strcmp(), the built-in scalars by value, lists and repeated arguments by their values
+ * and values of custom parsers by their bytes. In ARGUS_LAZY mode only the values that have been read through their
+ * accessors are compared.
+ *
+ * @param[in] a The old arguments
+ * @param[in] b The new arguments
+ *
+ * @return Bit ARGUS_ID(name) is set for every field that differs, test it with ARGUS_CHANGED()
+ */
+ARGUS_API argus_diff_t argus_diff(const args_t* a, const args_t* b) {
+    argus_diff_t diff = {{0}};
+#define ARGUS_MARK_CHANGED(name) diff.bits[ARGUS_ID(name) / 64] |= (uint64_t)1 << (ARGUS_ID(name) % 64);
+#define REQUIRED_ARG(type, name, label, description, parser) \
+    if (ARGUS_FIELD_DIFFERS(a->name, b->name, parser)) ARGUS_MARK_CHANGED(name)
+#define OPTIONAL_ARG(type, name, shortopt, longopt, arg_label, default, description, formatter, parser) \
+    if (ARGUS_FIELD_DIFFERS(a->name, b->name, parser)) ARGUS_MARK_CHANGED(name)
+#define BOOLEAN_ARG(name, ...) \
+    if (ARGUS_GETTER(name)(a) != ARGUS_GETTER(name)(b)) ARGUS_MARK_CHANGED(name)
+#define REPEATED_ARG(type, name, shortopt, longopt, arg_label, description, parser) \
+    if (a->name##_count != b->name##_count) {                                       \
+        ARGUS_MARK_CHANGED(name)                                                    \
+    } else {                                                                        \
+        for (size_t i = 0; i < a->name##_count; i++) {                              \
+            if (ARGUS_FIELD_DIFFERS(a->name[i], b->name[i], parser)) {              \
+                ARGUS_MARK_CHANGED(name)                                            \
+                break;                                                              \
+            }                                                                       \
+        }                                                                           \
+    }
+#ifdef REQUIRED_ARGS
+    REQUIRED_ARGS
+#endif
 #ifdef OPTIONAL_ARGS
     OPTIONAL_ARGS
 #endif
-#undef OPTIONAL_ARG
-
 #ifdef BOOLEAN_ARGS
     BOOLEAN_ARGS
 #endif
+#ifdef REPEATED_ARGS
+    REPEATED_ARGS
+#endif
+#undef REQUIRED_ARG
+#undef OPTIONAL_ARG
 #undef BOOLEAN_ARG
+#undef REPEATED_ARG
+#undef ARGUS_MARK_CHANGED
+    (void)a;  // Unused without arguments
+    (void)b;
+    return diff;
+}
+#endif
+#undef ARGUS_GETTER
+#undef ARGUS_SETTER
+#undef ARGUS_WRAPPED
+#ifdef ARGUS_PREFIX
+#undef REQUIRED_ARG_COUNT
+#undef OPTIONAL_ARG_COUNT
+#undef BOOLEAN_ARG_COUNT
+#undef REPEATED_ARG_COUNT
+#undef args_t
+#undef make_default_args
+#undef free_args
+#undef ARGUS_OPTION_COUNT
+#undef ARGUS_FIELD_COUNT
+#undef argus_diff_t
+#undef argus_long_names
+#undef ARGUS_LONG_SLOTS
+#undef argus_long_slots
+#undef argus_long_slots_ready
+#undef argus_build_long_slots
+#undef argus_find_long
+#undef argus_long_order
+#undef argus_long_order_count
+#undef argus_long_order_ready
+#undef argus_build_long_order
+#undef argus_find_abbrev
+#undef argus_short_ids
+#undef argus_short_ids_ready
+#undef argus_build_short_ids
+#undef argus_find_short
+#undef argus_parse_ns
+#undef argus_descriptors
+#undef argus_descriptor_count
+#undef argus_table_find_long
+#undef argus_table_find_short
+#undef argus_table_store
+#undef argus_table_set_flag
+#undef argus_table_positional
+#undef argus_scan
+#undef argus_parse_argv
+#undef argus_parse_response_files
+#undef argus_takes_next_value
+#undef argus_follow_scan
+#undef parse_args_arena_ex
+#undef parse_args_ex
+#undef parse_args_r
+#undef parse_args_arena
+#undef parse_args
+#undef parse_args_line_ex
+#undef parse_args_line
+#undef args_batch_t
+#undef argus_batch_layout
+#undef argus_batch_job_t
+#undef argus_batch_lines
+#undef argus_batch_worker
+#undef parse_args_batch
+#undef free_args_batch
+#undef args_reload_t
+#undef argus_reload_shadow
+#undef argus_reload_drained
+#undef args_reload_init
+#undef args_reload_begin
+#undef args_reload_publish
+#undef args_reload_register
+#undef args_reload_read
+#undef args_reload_quiescent
+#undef args_reload_unregister
+#undef free_args_reload
+#undef argus_render_help
+#undef argus_help_static
+#undef argus_help
+#undef argus_help_rendered_for
+#undef argus_help_alias_length
+#undef argus_help_string
+#undef print_help
+#undef argus_spellings
+#undef argus_spelling_count
+#undef argus_sorted_spellings
+#undef argus_sorted_spellings_ready
+#undef argus_sort_spellings
+#undef complete_args
+#undef print_completion
+#undef argus_layout
+#undef argus_serialize
+#undef argus_deserialize
+#undef argus_to_argv
+#undef argus_diff
+#undef argus_env_names
+#undef ARGUS_ENV_SLOTS
+#undef argus_env_slots
+#undef argus_env_slots_ready
+#undef parse_env_ex
+#undef parse_env
+#undef parse_config_buffer_ex
+#undef parse_config_file_ex
+#undef parse_config_buffer
+#undef parse_config_file
+#undef REQUIRED_ARGS
+#undef OPTIONAL_ARGS
+#undef BOOLEAN_ARGS
+#undef REPEATED_ARGS
+#undef POSITIONAL_SINK
+#undef ENV_ARGS
+#undef ARGUS_PREFIX
+#endif
+#endif
+
+// COMMANDS
+// Every COMMAND(name, description) refers to an argument set generated with ARGUS_PREFIX name_
+#if defined(COMMANDS) && !defined(ARGUS_COMMANDS_H)
+#define ARGUS_COMMANDS_H
+
+#define COMMAND(name, description) ARGUS_COMMAND_##name,
+typedef enum { COMMANDS ARGUS_COMMAND_COUNT } argus_command_t;
+#undef COMMAND
+
+// The chosen command and its arguments, only the member of that command is valid
+#define COMMAND(name, description) name##_args_t name;
+typedef struct {
+    argus_command_t command;
+    union {
+        COMMANDS
+    } as;
+} commands_t;
+#undef COMMAND
+
+#ifdef ARGUS_DECLARATIONS_ONLY
+ARGUS_API int parse_command_ex(const int argc, const char* const argv[], commands_t* commands, argus_error_t* err);
+ARGUS_API int parse_command(const int argc, const char* const argv[], commands_t* commands);
+ARGUS_API void free_command(commands_t* commands);
+ARGUS_API void print_commands_help(const char* exec_alias);
+ARGUS_API void print_command_help(argus_command_t command, const char* exec_alias);
+#else
+/**
+ * @brief Parse a command line of the form "program <command> [<args>]" without printing anything
+ *
+ * Only the argument set of the chosen command is scanned. Its argv starts at the command, so argv[0] of the
+ * command is its name. Error indices count from the start of the whole argv.
+ *
+ * @param[in]  argc      Number of command-line arguments (standard main() argc).
+ * @param[in]  argv      Array of argument strings (standard main() argv).
+ * @param[out] commands  The chosen command and its arguments, the others keeping their defaults
+ * @param[out] err       Filled with the reason parsing failed, may be NULL
+ *
+ * @retval 1 Error
+ * @retval 0 OK
+ */
+ARGUS_API int parse_command_ex(const int argc, const char* const argv[], commands_t* commands, argus_error_t* err) {
+    argus_error_t ignored;
+    if (err == NULL) err = &ignored;
+    *err = (argus_error_t){.code = ARGUS_OK, .index = -1};
+    if (!argc || !argv) ARGUS_FAIL(.code = ARGUS_ERROR_NULL_ARGV, .index = -1);
+    if (argc < 2) ARGUS_FAIL(.code = ARGUS_ERROR_MISSING_COMMAND, .index = 1);
+
+    const size_t len = strlen(argv[1]);
+    int result;
+#define COMMAND(name, description)                                                             \
+    if (len == sizeof(#name) - 1 && memcmp(argv[1], #name, sizeof(#name) - 1) == 0) {          \
+        commands->command = ARGUS_COMMAND_##name;                                              \
+        commands->as.name = name##_make_default_args();                                        \
+        result            = name##_parse_args_ex(argc - 1, argv + 1, &commands->as.name, err); \
+    } else
+    COMMANDS {
+        ARGUS_FAIL(.code = ARGUS_ERROR_UNKNOWN_COMMAND, .index = 1, .argument = argv[1]);
+    }
+#undef COMMAND
+
+    if (result != 0 && err->index >= 0) err->index++;
+    return result;
+}
+
+/**
+ * @brief Parse a command line of the form "program <command> [<args>]"
+ *
+ * Errors are printed to stderr.
+ *
+ * @param[in]  argc      Number of command-line arguments (standard main() argc).
+ * @param[in]  argv      Array of argument strings (standard main() argv).
+ * @param[out] commands  The chosen command and its arguments
+ *
+ * @retval 1 Error
+ * @retval 0 OK
+ */
+ARGUS_API int parse_command(const int argc, const char* const argv[], commands_t* commands) {
+    argus_error_t err;
+    if (parse_command_ex(argc, argv, commands, &err) == 0) return 0;
+    // Custom parsers notify the user themselves
+    if (err.code != ARGUS_ERROR_PARSER) argus_print_error(&err);
+    return 1;
+}
+
+// Release the storage parse_command allocated for repeated arguments of the chosen command
+ARGUS_API void free_command(commands_t* commands) {
+    switch (commands->command) {
+#define COMMAND(name, description)            \
+    case ARGUS_COMMAND_##name:                \
+        name##_free_args(&commands->as.name); \
+        break;
+        COMMANDS
+#undef COMMAND
+        case ARGUS_COMMAND_COUNT:
+            break;
+    }
 }
 
+// Display the list of commands, given command used to launch program, e.g., argv[0]
+ARGUS_API void print_commands_help(const char* exec_alias) {
+    argus_print(ARGUS_STDOUT, "USAGE:\n    %s <command> [<args>]\n\nCOMMANDS:\n", exec_alias);
+
+    // Every command adds a member as wide as its name, which makes the size of the union the widest name
+#define COMMAND(name, description) char name[sizeof(#name) - 1];
+    union argus_command_widths {
+        char argus_none;
+        COMMANDS
+    };
+#undef COMMAND
+    const int max_width = (int)sizeof(union argus_command_widths);
+
+#define COMMAND(name, description) \
+    argus_print(ARGUS_STDOUT, "    " #name "%*s  " description "\n", max_width - ((int)sizeof(#name) - 1), "");
+    COMMANDS
+#undef COMMAND
+}
+
+// Display the help of a single command, given command used to launch it, e.g., "program command"
+ARGUS_API void print_command_help(argus_command_t command, const char* exec_alias) {
+    switch (command) {
+#define COMMAND(name, description)     \
+    case ARGUS_COMMAND_##name:         \
+        name##_print_help(exec_alias); \
+        break;
+        COMMANDS
+#undef COMMAND
+        case ARGUS_COMMAND_COUNT:
+            break;
+    }
+}
+#endif
 #endif
 
 /*